@@ -0,0 +1,267 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "knapsack/knapsack_bnb.hpp"
+#include "knapsack/knapsack_dp.hpp"
+#include "knapsack/streaming_knapsack_bnb.hpp"
+#include "knapsack/unbounded_knapsack_bnb.hpp"
+
+#include "utils/instance_parsers.hpp"
+#include "utils/pisinger_generator.hpp"
+
+namespace Knapsack = fhamonic::knapsack;
+
+using Item = Instance<int, int>::Item;
+
+// searches that exceed it are stopped and reported with timeouts = 1, set with
+// --solve_timeout_s=<seconds>, 0 disabling it
+std::chrono::seconds solve_timeout(10);
+// knapsack_dp is skipped on instances whose table would exceed it
+constexpr double max_dp_cells = 1 << 30;
+
+// Resets the peak resident set size of the process (Linux >= 4.0), so that
+// the one read after a benchmark is its own and not the maximum of the
+// previous ones.
+void reset_peak_rss() {
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5";
+}
+
+double peak_rss_kb() {
+    std::ifstream status("/proc/self/status");
+    for(std::string line; std::getline(status, line);)
+        if(line.starts_with("VmHWM:")) return std::stod(line.substr(6));
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_maxrss);
+}
+
+// solve(instance, capped) returns the value found and whether it is optimal,
+// the search being stopped after solve_timeout if capped. The instance is
+// first solved once capped, outside of the timed loop, whose iterations then
+// time the uncapped solve() unless this one timed out, so that the measured
+// code path is the default one and that no timeout thread is started per
+// iteration.
+template <typename INSTANCE, typename F>
+void run(benchmark::State & state, const INSTANCE & instance, F && solve) {
+    reset_peak_rss();
+    int value = 0;
+    bool optimal = true;
+    if(solve_timeout.count() > 0)
+        std::tie(value, optimal) = solve(instance, true);
+    const bool capped = !optimal;
+    for(auto _ : state) {
+        std::tie(value, optimal) = solve(instance, capped);
+        benchmark::DoNotOptimize(value);
+    }
+    state.counters["items"] = static_cast<double>(instance.itemCount());
+    state.counters["value"] = value;
+    state.counters["timeouts"] = optimal ? 0 : 1;
+    if(const auto opt = instance.getKnownOptimum())
+        state.counters["gap"] = *opt - value;
+    state.counters["peak_rss_kB"] = peak_rss_kb();
+}
+
+template <typename INSTANCE>
+void bench_knapsack_bnb(benchmark::State & state, const INSTANCE & instance) {
+    run(state, instance, [](const INSTANCE & inst, const bool capped) {
+        auto solver = Knapsack::knapsack_bnb(inst.getBudget(), inst.items(),
+                                             inst.valueMap(), inst.costMap());
+        bool optimal = true;
+        if(capped)
+            optimal = solver.solve(solve_timeout);
+        else
+            solver.solve();
+        int value = 0;
+        for(const Item & i : solver.solution()) value += i.value;
+        return std::make_pair(value, optimal);
+    });
+}
+
+template <typename INSTANCE>
+void bench_streaming_knapsack_bnb(benchmark::State & state,
+                                  const INSTANCE & instance) {
+    run(state, instance, [](const INSTANCE & inst, const bool capped) {
+        auto solver = Knapsack::streaming_knapsack_bnb(
+            inst.getBudget(), inst.items(), inst.valueMap(), inst.costMap());
+        bool optimal = true;
+        if(capped)
+            optimal = solver.solve(solve_timeout);
+        else
+            solver.solve();
+        int value = 0;
+        for(const Item & i : solver.solution()) value += i.value;
+        return std::make_pair(value, optimal);
+    });
+}
+
+template <typename INSTANCE>
+void bench_knapsack_dp(benchmark::State & state, const INSTANCE & instance) {
+    const double nb_cells = static_cast<double>(instance.itemCount()) *
+                            (static_cast<double>(instance.getBudget()) + 1);
+    if(nb_cells > max_dp_cells) {
+        state.SkipWithError("dynamic programming table too large");
+        return;
+    }
+    run(state, instance, [](const INSTANCE & inst, bool) {
+        auto solver = Knapsack::knapsack_dp(inst.getBudget(), inst.items(),
+                                            inst.valueMap(), inst.costMap());
+        solver.solve();
+        int value = 0;
+        for(const Item & i : solver.solution()) value += i.value;
+        return std::make_pair(value, true);
+    });
+    state.counters["cells"] = benchmark::Counter(
+        nb_cells, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template <typename INSTANCE>
+void bench_unbounded_knapsack_bnb(benchmark::State & state,
+                                  const INSTANCE & instance) {
+    run(state, instance, [](const INSTANCE & inst, const bool capped) {
+        auto solver = Knapsack::unbounded_knapsack_bnb(
+            inst.getBudget(), inst.items(), inst.valueMap(), inst.costMap());
+        bool optimal = true;
+        if(capped)
+            optimal = solver.solve(solve_timeout);
+        else
+            solver.solve();
+        int value = 0;
+        for(auto && [i, nb] : solver.solution())
+            value += i.value * static_cast<int>(nb);
+        return std::make_pair(value, optimal);
+    });
+}
+
+// registered benchmarks refer to them
+std::vector<std::unique_ptr<Instance<int, int>>> instances;
+
+using Parser = Instance<int, int> (*)(const std::filesystem::path &,
+                                      std::size_t);
+using Bench = void (*)(benchmark::State &, const Instance<int, int> &);
+
+std::vector<std::filesystem::path> instance_files(
+    const std::filesystem::path & directory, const std::string & prefix,
+    const std::string & extension = "") {
+    std::vector<std::filesystem::path> files;
+    for(auto && entry : std::filesystem::directory_iterator(directory)) {
+        const std::filesystem::path & path = entry.path();
+        if(!entry.is_regular_file() ||
+           !path.filename().string().starts_with(prefix) ||
+           (!extension.empty() && path.extension() != extension))
+            continue;
+        files.push_back(path);
+    }
+    std::ranges::sort(files);
+    return files;
+}
+
+void register_benchmarks(const std::string & group,
+                         const std::vector<std::filesystem::path> & files,
+                         const Parser parser,
+                         const std::vector<std::pair<std::string, Bench>> &
+                             engines) {
+    for(auto && path : files) {
+        instances.push_back(
+            std::make_unique<Instance<int, int>>(parser(path, 1)));
+        const Instance<int, int> & instance = *instances.back();
+        for(auto && [engine_name, bench] : engines) {
+            benchmark::RegisterBenchmark(
+                (engine_name + "/" + group + "/" + path.filename().string())
+                    .c_str(),
+                bench, std::cref(instance))
+                ->Unit(benchmark::kMillisecond)
+                ->UseRealTime();
+        }
+    }
+}
+
+// Pisinger instances of increasing sizes, the items are generated on the fly
+// by the solvers constructors
+std::vector<std::unique_ptr<PisingerInstance<int, int>>> generated_instances;
+
+void register_generated_benchmarks() {
+    using Generated = PisingerInstance<int, int>;
+    const std::vector<std::pair<std::string, void (*)(benchmark::State &,
+                                                      const Generated &)>>
+        engines = {
+            {"knapsack_bnb", bench_knapsack_bnb<Generated>},
+            {"streaming_knapsack_bnb", bench_streaming_knapsack_bnb<Generated>},
+            {"knapsack_dp", bench_knapsack_dp<Generated>}};
+    constexpr std::int64_t range = 1000;
+    constexpr double capacity_ratio = 0.5;
+    constexpr std::uint64_t seed = 0;
+    for(auto && [instance_class, class_name] : pisinger_class_names) {
+        for(const std::size_t nb_items :
+             {std::size_t{1000}, std::size_t{10000}, std::size_t{100000}}) {
+            generated_instances.push_back(std::make_unique<Generated>(
+                instance_class, nb_items, range, capacity_ratio, seed));
+            const Generated & instance = *generated_instances.back();
+            for(auto && [engine_name, bench] : engines) {
+                benchmark::RegisterBenchmark(
+                    (engine_name + "/generated/" + std::string(class_name) +
+                     "/" + std::to_string(nb_items))
+                        .c_str(),
+                    bench, std::cref(instance))
+                    ->Unit(benchmark::kMillisecond)
+                    ->UseRealTime();
+            }
+        }
+    }
+}
+
+int main(int argc, char ** argv) {
+    const std::string_view timeout_flag = "--solve_timeout_s=";
+    for(int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if(!arg.starts_with(timeout_flag)) continue;
+        solve_timeout = std::chrono::seconds(
+            std::stoi(std::string(arg.substr(timeout_flag.size()))));
+        std::copy(argv + i + 1, argv + argc, argv + i);
+        --argc;
+        --i;
+    }
+
+    const std::filesystem::path instances_dir = INSTANCES_DIRECTORY;
+    const std::vector<std::pair<std::string, Bench>> engines_01 = {
+        {"knapsack_bnb", bench_knapsack_bnb<Instance<int, int>>},
+        {"streaming_knapsack_bnb",
+         bench_streaming_knapsack_bnb<Instance<int, int>>},
+        {"knapsack_dp", bench_knapsack_dp<Instance<int, int>>}};
+
+    register_benchmarks("sac",
+                        instance_files(instances_dir / "knapsack", "sac"),
+                        parse_tp_instance, engines_01);
+    register_benchmarks(
+        "low-dimensional",
+        instance_files(instances_dir / "knapsack/low-dimensional", ""),
+        parse_classic_instance, engines_01);
+    register_benchmarks(
+        "large_scale",
+        instance_files(instances_dir / "knapsack/large_scale", "knapPI"),
+        parse_classic_instance, engines_01);
+    register_benchmarks(
+        "ukp",
+        instance_files(instances_dir / "unbounded_knapsack", "", ".ukp"),
+        parse_unbounded_instance,
+        {{"unbounded_knapsack_bnb",
+          bench_unbounded_knapsack_bnb<Instance<int, int>>}});
+    register_generated_benchmarks();
+
+    benchmark::Initialize(&argc, argv);
+    if(benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -24,6 +24,7 @@ class CompressorRecipe(ConanFile):
     def build_requirements(self):
         self.tool_requires("cmake/[>=3.19.0]")
         self.test_requires("gtest/[>=1.10.0 <cci]")
+        self.test_requires("benchmark/[>=1.6.0]")
 
     def generate(self):
         print("conanfile.py: IDE include dirs:")
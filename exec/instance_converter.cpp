@@ -0,0 +1,42 @@
+#include <filesystem>
+#include <iostream>
+#include <string_view>
+
+#include "utils/binary_instance.hpp"
+#include "utils/instance_parsers.hpp"
+
+int main(int argc, const char * argv[]) {
+    if(argc < 4) {
+        std::cerr << "input requiered : <tp|classic|ukp> <instance_file> "
+                     "<binary_instance_file>"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::string_view format = argv[1];
+    std::filesystem::path instance_path = argv[2];
+    std::filesystem::path binary_instance_path = argv[3];
+    if(!std::filesystem::exists(instance_path)) {
+        std::cerr << instance_path << ":"
+                  << " File does not exists" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Instance<int, int> instance;
+    if(format == "tp") {
+        instance = parse_tp_instance(instance_path);
+    } else if(format == "classic") {
+        instance = parse_classic_instance(instance_path);
+    } else if(format == "ukp") {
+        instance = parse_unbounded_instance(instance_path);
+    } else {
+        std::cerr << format << ": unknown format, expected tp, classic or ukp"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    write_binary_instance(binary_instance_path, instance);
+    std::cout << instance.itemCount() << " items written to "
+              << binary_instance_path << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,61 @@
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "utils/binary_instance.hpp"
+#include "utils/pisinger_generator.hpp"
+
+template <typename T>
+bool parse_arg(const std::string_view arg, T & value) {
+    const auto [ptr, ec] =
+        std::from_chars(arg.data(), arg.data() + arg.size(), value);
+    return ec == std::errc() && ptr == arg.data() + arg.size();
+}
+
+int main(int argc, const char * argv[]) {
+    if(argc < 7) {
+        std::cerr << "input requiered : <class> <nb_items> <range> "
+                     "<capacity_ratio> <seed> <instance_file>\n"
+                     "classes :";
+        for(auto && [c, name] : pisinger_class_names) std::cerr << ' ' << name;
+        std::cerr << "\nthe instance is written in the classic format, or in "
+                     "the binary one if the file extension is .kbin"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::optional<PisingerClass> instance_class =
+        parse_pisinger_class(argv[1]);
+    std::size_t nb_items;
+    std::int64_t range;
+    std::uint64_t seed;
+    double capacity_ratio;
+    if(!instance_class) {
+        std::cerr << argv[1] << ": unknown instance class" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if(!parse_arg(argv[2], nb_items) || !parse_arg(argv[3], range) ||
+       !parse_arg(argv[4], capacity_ratio) || !parse_arg(argv[5], seed)) {
+        std::cerr << "invalid numeric argument" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::filesystem::path instance_path = argv[6];
+
+    const PisingerInstance<int, int> instance(*instance_class, nb_items, range,
+                                              capacity_ratio, seed);
+    if(instance_path.extension() == ".kbin") {
+        write_binary_instance(instance_path, instance.toInstance());
+    } else {
+        std::ofstream file(instance_path);
+        file << instance.itemCount() << ' ' << instance.getBudget() << '\n';
+        for(auto && i : instance.items())
+            file << i.value << ' ' << i.cost << '\n';
+    }
+    std::cout << instance.itemCount() << " items written to " << instance_path
+              << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -3,11 +3,33 @@
 
 #include "knapsack/knapsack_bnb.hpp"
 
+#include "utils/binary_instance.hpp"
 #include "utils/chrono.hpp"
 #include "utils/instance_parsers.hpp"
 
 namespace Knapsack = fhamonic::knapsack;
 
+template <typename INSTANCE>
+void solve_and_print(const INSTANCE & instance) {
+    const auto value_map = instance.valueMap();
+    Chrono chrono;
+
+    auto knapsack = Knapsack::knapsack_bnb(
+        instance.getBudget(), instance.items(), value_map, instance.costMap());
+
+    knapsack.solve();
+    // knapsack.solve(std::chrono::seconds(10));
+
+    int time_us = chrono.timeUs();
+
+    int solution_value = 0;
+    for(auto && i : knapsack.solution()) {
+        // std::cout << value_map(i) << " " << cost_map(i) << std::endl;
+        solution_value += value_map(i);
+    }
+    std::cout << solution_value << " in " << time_us << " µs" << std::endl;
+}
+
 int main(int argc, const char * argv[]) {
     if(argc < 2) {
         std::cerr << "input requiered : <knapsack_instance_file>" << std::endl;
@@ -20,31 +42,16 @@ int main(int argc, const char * argv[]) {
         return EXIT_FAILURE;
     }
 
-    Instance instance = parse_tp_instance(instance_path);
-    // Instance instance = parse_classic_instance(instance_path);
-
-    Chrono chrono;
-
-    auto knapsack = Knapsack::knapsack_bnb(
-        instance.getBudget(), instance.items(),
-        [&instance](const Instance<int, int>::Item & i) {
-            return i.value;
-        },
-        [&instance](const Instance<int, int>::Item & i) {
-            return i.cost;
-        });
-
-    knapsack.solve();
-    // knapsack.solve(std::chrono::seconds(10));
+    if(instance_path.extension() == ".kbin") {
+        const BinaryInstance<int, int> instance(instance_path);
+        solve_and_print(instance.view());
+        return EXIT_SUCCESS;
+    }
 
-    int time_us = chrono.timeUs();
+    const InstanceColumns instance(parse_tp_instance(instance_path));
+    // Instance instance = parse_classic_instance(instance_path);
 
-    int solution_value = 0;
-    for(auto && i : knapsack.solution()) {     
-        // std::cout << i.value << " " << i.cost << std::endl;
-        solution_value += i.value;
-    }
-    std::cout << solution_value << " in " << time_us << " µs" << std::endl;
+    solve_and_print(instance.view());
 
     return EXIT_SUCCESS;
 }
@@ -3,34 +3,17 @@
 
 #include "knapsack/unbounded_knapsack_bnb.hpp"
 
+#include "utils/binary_instance.hpp"
 #include "utils/chrono.hpp"
 #include "utils/instance_parsers.hpp"
 
-int main(int argc, const char * argv[]) {
-    if(argc < 2) {
-        std::cerr << "input requiered : <knapsack_instance_file>" << std::endl;
-        return EXIT_FAILURE;
-    }
-    std::filesystem::path instance_path = argv[1];
-    if(!std::filesystem::exists(instance_path)) {
-        std::cerr << instance_path << ":"
-                  << " File does not exists" << std::endl;
-        return EXIT_FAILURE;
-    }
-
-    Instance<int, int> instance =
-        parse_unbounded_instance(instance_path);
-
+template <typename INSTANCE>
+void solve_and_print(const INSTANCE & instance) {
+    const auto value_map = instance.valueMap();
     Chrono chrono;
 
     auto unbounded_knapsack = fhamonic::knapsack::unbounded_knapsack_bnb(
-        instance.getBudget(), instance.items(),
-        [&instance](const Instance<int, int>::Item & i) {
-            return i.value;
-        },
-        [&instance](const Instance<int, int>::Item & i) {
-            return i.cost;
-        });
+        instance.getBudget(), instance.items(), value_map, instance.costMap());
 
     // unbounded_knapsack.solve();
     unbounded_knapsack.solve(std::chrono::seconds(30));
@@ -39,10 +22,32 @@ int main(int argc, const char * argv[]) {
 
     int solution_value = 0;
     for(auto && [i, nb] : unbounded_knapsack.solution()) {
-        // std::cout << i.value << " " << i.cost << std::endl;
-        solution_value += i.value * nb;
+        // std::cout << value_map(i) << " " << cost_map(i) << std::endl;
+        solution_value += value_map(i) * static_cast<int>(nb);
     }
     std::cout << solution_value << " in " << time_us << " µs" << std::endl;
+}
+
+int main(int argc, const char * argv[]) {
+    if(argc < 2) {
+        std::cerr << "input requiered : <knapsack_instance_file>" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::filesystem::path instance_path = argv[1];
+    if(!std::filesystem::exists(instance_path)) {
+        std::cerr << instance_path << ":"
+                  << " File does not exists" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if(instance_path.extension() == ".kbin") {
+        const BinaryInstance<int, int> instance(instance_path);
+        solve_and_print(instance.view());
+        return EXIT_SUCCESS;
+    }
+
+    Instance<int, int> instance = parse_unbounded_instance(instance_path);
+    solve_and_print(instance);
 
     return EXIT_SUCCESS;
 }
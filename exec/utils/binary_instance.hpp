@@ -0,0 +1,184 @@
+/**
+ * @file binary_instance.hpp
+ * @brief Versioned binary instance format, meant to be memory mapped.
+ *
+ * Layout (little-endian) :
+ *   [0, 64)          header, see BinaryInstanceHeader
+ *   [values_offset)  nb_items values, 64-byte aligned
+ *   [costs_offset)   nb_items costs, 64-byte aligned
+ */
+#ifndef BINARY_INSTANCE_HPP
+#define BINARY_INSTANCE_HPP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#include "utils/instance.hpp"
+#include "utils/instance_view.hpp"
+#include "utils/mapped_file.hpp"
+
+static_assert(std::endian::native == std::endian::little,
+              "the binary instance format is little-endian");
+
+enum class BinaryInstanceType : std::uint8_t {
+    int32 = 1,
+    int64 = 2,
+    uint32 = 3,
+    uint64 = 4,
+    float32 = 5,
+    float64 = 6
+};
+
+template <typename T>
+constexpr BinaryInstanceType binary_instance_type() {
+    if constexpr(std::is_floating_point_v<T>) {
+        static_assert(sizeof(T) == 4 || sizeof(T) == 8);
+        return sizeof(T) == 4 ? BinaryInstanceType::float32
+                              : BinaryInstanceType::float64;
+    } else {
+        static_assert(std::is_integral_v<T> && (sizeof(T) == 4 || sizeof(T) == 8));
+        if constexpr(std::is_signed_v<T>)
+            return sizeof(T) == 4 ? BinaryInstanceType::int32
+                                  : BinaryInstanceType::int64;
+        else
+            return sizeof(T) == 4 ? BinaryInstanceType::uint32
+                                  : BinaryInstanceType::uint64;
+    }
+}
+
+struct BinaryInstanceHeader {
+    static constexpr std::array<char, 8> expected_magic = {'K', 'N', 'A', 'P',
+                                                           'S', 'A', 'C', 'K'};
+    static constexpr std::uint32_t current_version = 1;
+    static constexpr std::uint32_t has_known_optimum = 1;
+    static constexpr std::uint64_t alignment = 64;
+
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint64_t nb_items;
+    BinaryInstanceType value_type;
+    BinaryInstanceType cost_type;
+    std::array<std::uint8_t, 6> padding;
+    std::array<std::byte, 8> budget;         // of cost type
+    std::array<std::byte, 8> known_optimum;  // of value type
+    std::uint64_t values_offset;
+    std::uint64_t costs_offset;
+};
+static_assert(sizeof(BinaryInstanceHeader) == 64);
+static_assert(std::is_trivially_copyable_v<BinaryInstanceHeader>);
+
+/**
+ * @brief Memory mapped binary instance, values and costs are spans over the
+ * mapping so that no item is copied.
+ */
+template <typename Value, typename Cost>
+class BinaryInstance {
+private:
+    MappedFile _file;
+    BinaryInstanceHeader _header;
+    Cost _budget;
+    std::optional<Value> _known_optimum;
+    std::span<const Value> _values;
+    std::span<const Cost> _costs;
+
+public:
+    explicit BinaryInstance(const std::filesystem::path & path) : _file(path) {
+        if(_file.size() < sizeof(BinaryInstanceHeader))
+            throw std::runtime_error(path.string() +
+                                     ": not a binary instance");
+        std::memcpy(&_header, _file.data(), sizeof(BinaryInstanceHeader));
+        if(_header.magic != BinaryInstanceHeader::expected_magic)
+            throw std::runtime_error(path.string() +
+                                     ": not a binary instance");
+        if(_header.version != BinaryInstanceHeader::current_version)
+            throw std::runtime_error(path.string() +
+                                     ": unsupported binary instance version");
+        if(_header.value_type != binary_instance_type<Value>() ||
+           _header.cost_type != binary_instance_type<Cost>())
+            throw std::runtime_error(path.string() +
+                                     ": unexpected value or cost type");
+        const std::uint64_t n = _header.nb_items;
+        if(_header.values_offset % alignof(Value) != 0 ||
+           _header.costs_offset % alignof(Cost) != 0 ||
+           _header.values_offset + n * sizeof(Value) > _file.size() ||
+           _header.costs_offset + n * sizeof(Cost) > _file.size())
+            throw std::runtime_error(path.string() +
+                                     ": truncated binary instance");
+
+        std::memcpy(&_budget, _header.budget.data(), sizeof(Cost));
+        if(_header.flags & BinaryInstanceHeader::has_known_optimum) {
+            Value opt;
+            std::memcpy(&opt, _header.known_optimum.data(), sizeof(Value));
+            _known_optimum = opt;
+        }
+        _values = std::span<const Value>(
+            reinterpret_cast<const Value *>(_file.data() +
+                                            _header.values_offset),
+            static_cast<std::size_t>(n));
+        _costs = std::span<const Cost>(
+            reinterpret_cast<const Cost *>(_file.data() + _header.costs_offset),
+            static_cast<std::size_t>(n));
+    }
+
+    Cost getBudget() const { return _budget; }
+    std::size_t itemCount() const { return _values.size(); }
+    std::optional<Value> getKnownOptimum() const { return _known_optimum; }
+    std::span<const Value> values() const { return _values; }
+    std::span<const Cost> costs() const { return _costs; }
+
+    // the view must not outlive the mapping
+    InstanceView<Value, Cost> view() const {
+        return InstanceView<Value, Cost>(_budget, _values, _costs,
+                                         _known_optimum);
+    }
+};
+
+template <typename Value, typename Cost>
+void write_binary_instance(const std::filesystem::path & path,
+                           const Instance<Value, Cost> & instance) {
+    const std::uint64_t n = instance.itemCount();
+    auto align = [](std::uint64_t offset) {
+        return (offset + BinaryInstanceHeader::alignment - 1) /
+               BinaryInstanceHeader::alignment *
+               BinaryInstanceHeader::alignment;
+    };
+
+    BinaryInstanceHeader header{};
+    header.magic = BinaryInstanceHeader::expected_magic;
+    header.version = BinaryInstanceHeader::current_version;
+    header.nb_items = n;
+    header.value_type = binary_instance_type<Value>();
+    header.cost_type = binary_instance_type<Cost>();
+    const Cost budget = instance.getBudget();
+    std::memcpy(header.budget.data(), &budget, sizeof(Cost));
+    if(const std::optional<Value> opt = instance.getKnownOptimum()) {
+        header.flags |= BinaryInstanceHeader::has_known_optimum;
+        std::memcpy(header.known_optimum.data(), &*opt, sizeof(Value));
+    }
+    header.values_offset = align(sizeof(BinaryInstanceHeader));
+    header.costs_offset = align(header.values_offset + n * sizeof(Value));
+
+    std::ofstream file(path, std::ios::binary);
+    auto pad_to = [&file](std::uint64_t offset) {
+        while(static_cast<std::uint64_t>(file.tellp()) < offset) file.put(0);
+    };
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    pad_to(header.values_offset);
+    for(auto && item : instance.getItems())
+        file.write(reinterpret_cast<const char *>(&item.value), sizeof(Value));
+    pad_to(header.costs_offset);
+    for(auto && item : instance.getItems())
+        file.write(reinterpret_cast<const char *>(&item.cost), sizeof(Cost));
+    if(!file) throw std::runtime_error(path.string() + ": write failed");
+}
+
+#endif  // BINARY_INSTANCE_HPP
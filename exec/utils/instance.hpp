@@ -2,6 +2,7 @@
 #define FHAMONIC_KNAPSACK_INSTANCE_HPP
 
 #include <limits>
+#include <optional>
 #include <vector>
 
 template <typename Value, typename Cost>
@@ -14,7 +15,6 @@ public:
 
     public:
         Item(Value v, Cost c) : value{v}, cost{c} {}
-        Item(const Item & item) : value{item.value}, cost{item.cost} {}
         double getRatio() const {
             if(cost == 0) return std::numeric_limits<double>::max();
             return static_cast<double>(value) / static_cast<double>(cost);
@@ -27,6 +27,7 @@ public:
 private:
     Cost budget;
     std::vector<Item> _items;
+    std::optional<Value> _known_optimum;
 
 public:
     Instance() {}
@@ -34,13 +35,23 @@ public:
     void setBudget(Cost b) { budget = b; }
     Cost getBudget() const { return budget; }
 
+    void setKnownOptimum(Value opt) { _known_optimum = opt; }
+    std::optional<Value> getKnownOptimum() const { return _known_optimum; }
+
+    void reserveItems(std::size_t n) { _items.reserve(n); }
     void addItem(Value v, Cost w) { _items.push_back(Item(v, w)); }
     size_t itemCount() const { return _items.size(); }
-    auto items() const { return _items; }
+    const std::vector<Item> & items() const { return _items; }
+    auto valueMap() const {
+        return [](const Item & i) { return i.value; };
+    }
+    auto costMap() const {
+        return [](const Item & i) { return i.cost; };
+    }
 
     const std::vector<Item> & getItems() const { return _items; }
-    const Item getItem(const std::size_t i) const { return _items[static_cast<std::size_t>(i)]; }
-    const Item operator[](const std::size_t i) const { return _items[i]; }
+    const Item & getItem(const std::size_t i) const { return _items[i]; }
+    const Item & operator[](const std::size_t i) const { return _items[i]; }
 };
 
 #endif  // FHAMONIC_KNAPSACK_INSTANCE_HPP
\ No newline at end of file
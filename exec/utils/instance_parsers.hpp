@@ -1,58 +1,155 @@
 #ifndef INSTANCE_PARSER_HPP
 #define INSTANCE_PARSER_HPP
 
+#include <algorithm>
+#include <charconv>
 #include <filesystem>
-#include <fstream>
-#include <iostream>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 #include "utils/instance.hpp"
+#include "utils/mapped_file.hpp"
+
+inline bool is_blank(const char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' ||
+           c == '\f';
+}
+
+// Parses whitespace separated ints until the end of the text or the first
+// token that is not an int.
+inline const char * parse_integers(const char * it, const char * const end,
+                                   std::vector<int> & integers) {
+    for(;;) {
+        while(it < end && is_blank(*it)) ++it;
+        if(it == end) return it;
+        // fast path : up to 9 ASCII digits cannot overflow an int
+        const char * const token = it;
+        int value = 0;
+        while(it < end && it - token < 9 &&
+              static_cast<unsigned char>(*it - '0') < 10) {
+            value = value * 10 + (*it - '0');
+            ++it;
+        }
+        if(it > token && (it == end || is_blank(*it))) {
+            integers.push_back(value);
+            continue;
+        }
+        const auto [ptr, ec] = std::from_chars(token, end, value);
+        if(ec != std::errc() || (ptr < end && !is_blank(*ptr))) return token;
+        integers.push_back(value);
+        it = ptr;
+    }
+}
+
+// Parses the text in nb_threads chunks split on blanks, concatenating the
+// results. Parsing stops at the first chunk that contains an invalid token.
+inline std::vector<int> parse_integers(std::string_view text,
+                                       std::size_t nb_threads = 1) {
+    const char * const begin = text.data();
+    const char * const end = begin + text.size();
+    std::vector<int> integers;
+    if(nb_threads <= 1) {
+        integers.reserve(text.size() / 4);
+        parse_integers(begin, end, integers);
+        return integers;
+    }
+
+    std::vector<const char *> bounds = {begin};
+    for(std::size_t t = 1; t < nb_threads; ++t) {
+        const char * bound = std::max(
+            bounds.back(), begin + text.size() / nb_threads * t);
+        while(bound < end && !is_blank(*bound)) ++bound;
+        bounds.push_back(bound);
+    }
+    bounds.push_back(end);
+
+    std::vector<std::vector<int>> chunks_integers(nb_threads);
+    std::vector<char> chunks_complete(nb_threads);
+    {
+        std::vector<std::jthread> threads;
+        for(std::size_t t = 0; t < nb_threads; ++t) {
+            threads.emplace_back([&, t] {
+                const std::size_t chunk_size =
+                    static_cast<std::size_t>(bounds[t + 1] - bounds[t]);
+                chunks_integers[t].reserve(chunk_size / 4);
+                chunks_complete[t] = (parse_integers(bounds[t], bounds[t + 1],
+                                                     chunks_integers[t]) ==
+                                      bounds[t + 1]);
+            });
+        }
+    }
+    std::size_t nb_integers = 0;
+    for(auto && chunk : chunks_integers) nb_integers += chunk.size();
+    integers.reserve(nb_integers);
+    for(std::size_t t = 0; t < nb_threads; ++t) {
+        integers.insert(integers.end(), chunks_integers[t].begin(),
+                        chunks_integers[t].end());
+        if(!chunks_complete[t]) break;
+    }
+    return integers;
+}
 
 inline Instance<int, int> parse_tp_instance(
-    const std::filesystem::path & instance_path) {
+    const std::filesystem::path & instance_path, std::size_t nb_threads = 1) {
     Instance<int, int> instance;
-    std::ifstream file(instance_path);
-    int budget;
-    file >> budget;
-    instance.setBudget(budget);
-    int value, weight;
-    while(file >> weight >> value) instance.addItem(value, weight);
+    const MappedFile file(instance_path);
+    const std::vector<int> integers = parse_integers(file.view(), nb_threads);
+    if(integers.empty()) return instance;
+    instance.setBudget(integers[0]);
+    const std::size_t nb_items = (integers.size() - 1) / 2;
+    instance.reserveItems(nb_items);
+    for(std::size_t i = 0; i < nb_items; ++i) {
+        const int weight = integers[1 + 2 * i];
+        const int value = integers[2 + 2 * i];
+        instance.addItem(value, weight);
+    }
     return instance;
 }
 
 inline Instance<int, int> parse_classic_instance(
-    const std::filesystem::path & instance_path) {
+    const std::filesystem::path & instance_path, std::size_t nb_threads = 1) {
     Instance<int, int> instance;
-    std::ifstream file(instance_path);
-    int nb_items, budget;
-    file >> nb_items >> budget;
-    instance.setBudget(budget);
-    int value, weight;
-    for(int i = 0; i < nb_items; ++i) {
-        file >> weight >> value;
+    const MappedFile file(instance_path);
+    const std::vector<int> integers = parse_integers(file.view(), nb_threads);
+    if(integers.size() < 2) return instance;
+    instance.setBudget(integers[1]);
+    const std::size_t nb_items =
+        std::min(static_cast<std::size_t>(std::max(integers[0], 0)),
+                 (integers.size() - 2) / 2);
+    instance.reserveItems(nb_items);
+    for(std::size_t i = 0; i < nb_items; ++i) {
+        const int weight = integers[2 + 2 * i];
+        const int value = integers[3 + 2 * i];
         instance.addItem(weight, value);
     }
-    int taken, opt = 0;
-    for(std::size_t i = 0; file >> taken; ++i) opt += taken * instance[i].value;
-    std::cout << "opt = " << opt << std::endl;
+    int opt = 0;
+    for(std::size_t i = 0; i < nb_items && 2 + 2 * nb_items + i < integers.size();
+        ++i)
+        opt += integers[2 + 2 * nb_items + i] * instance[i].value;
+    if(2 + 2 * nb_items < integers.size()) instance.setKnownOptimum(opt);
     return instance;
 }
 
 inline Instance<int, int> parse_unbounded_instance(
-    const std::filesystem::path & instance_path) {
+    const std::filesystem::path & instance_path, std::size_t nb_threads = 1) {
     Instance<int, int> instance;
-    std::ifstream file(instance_path);
-    int nb_items, budget;
-    file >> nb_items >> budget;
-    instance.setBudget(budget);
-    int value, weight;
-    for(int i = 0; i < nb_items; ++i) {
-        file >> value >> weight;
+    const MappedFile file(instance_path);
+    const std::vector<int> integers = parse_integers(file.view(), nb_threads);
+    if(integers.size() < 2) return instance;
+    instance.setBudget(integers[1]);
+    const std::size_t nb_items =
+        std::min(static_cast<std::size_t>(std::max(integers[0], 0)),
+                 (integers.size() - 2) / 2);
+    instance.reserveItems(nb_items);
+    for(std::size_t i = 0; i < nb_items; ++i) {
+        const int value = integers[2 + 2 * i];
+        const int weight = integers[3 + 2 * i];
         instance.addItem(weight, value);
     }
-    int opt;
-    file >> opt;
-    std::cout << "opt = " << opt << std::endl;
+    if(2 + 2 * nb_items < integers.size())
+        instance.setKnownOptimum(integers[2 + 2 * nb_items]);
     return instance;
 }
 
-#endif  // INSTANCE_PARSER_HPP
\ No newline at end of file
+#endif  // INSTANCE_PARSER_HPP
@@ -0,0 +1,85 @@
+#ifndef FHAMONIC_KNAPSACK_INSTANCE_VIEW_HPP
+#define FHAMONIC_KNAPSACK_INSTANCE_VIEW_HPP
+
+#include <cstddef>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include "utils/instance.hpp"
+
+/**
+ * @brief Non-owning instance over contiguous value and cost columns, e.g. the
+ * ones of a memory mapped BinaryInstance. Items are the indices of the
+ * columns so that solvers read the values and costs in place.
+ */
+template <typename Value, typename Cost>
+class InstanceView {
+private:
+    Cost _budget;
+    std::span<const Value> _values;
+    std::span<const Cost> _costs;
+    std::optional<Value> _known_optimum;
+
+public:
+    // values and costs must have the same size
+    InstanceView(Cost budget, std::span<const Value> values,
+                 std::span<const Cost> costs,
+                 std::optional<Value> known_optimum = std::nullopt)
+        : _budget(budget)
+        , _values(values)
+        , _costs(costs)
+        , _known_optimum(known_optimum) {}
+
+    Cost getBudget() const { return _budget; }
+    std::optional<Value> getKnownOptimum() const { return _known_optimum; }
+    std::size_t itemCount() const { return _values.size(); }
+
+    std::span<const Value> values() const { return _values; }
+    std::span<const Cost> costs() const { return _costs; }
+
+    auto items() const {
+        return std::views::iota(std::size_t{0}, _values.size());
+    }
+    auto valueMap() const {
+        return [values = _values](const std::size_t i) { return values[i]; };
+    }
+    auto costMap() const {
+        return [costs = _costs](const std::size_t i) { return costs[i]; };
+    }
+};
+
+/**
+ * @brief Value and cost columns copied from an Instance, e.g. a parsed text
+ * file, so that it is solved through the same InstanceView as a memory mapped
+ * BinaryInstance.
+ */
+template <typename Value, typename Cost>
+class InstanceColumns {
+private:
+    Cost _budget;
+    std::vector<Value> _values;
+    std::vector<Cost> _costs;
+    std::optional<Value> _known_optimum;
+
+public:
+    explicit InstanceColumns(const Instance<Value, Cost> & instance)
+        : _budget(instance.getBudget())
+        , _known_optimum(instance.getKnownOptimum()) {
+        _values.reserve(instance.itemCount());
+        _costs.reserve(instance.itemCount());
+        for(auto && item : instance.items()) {
+            _values.push_back(item.value);
+            _costs.push_back(item.cost);
+        }
+    }
+
+    // the view must not outlive the columns
+    InstanceView<Value, Cost> view() const {
+        return InstanceView<Value, Cost>(_budget, _values, _costs,
+                                         _known_optimum);
+    }
+};
+
+#endif  // FHAMONIC_KNAPSACK_INSTANCE_VIEW_HPP
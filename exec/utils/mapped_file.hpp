@@ -0,0 +1,81 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAPPED_FILE_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Read-only view of a whole file, memory mapped when the platform
+ * allows it and read in a buffer otherwise.
+ */
+class MappedFile {
+private:
+    const char * _data;
+    std::size_t _size;
+#ifdef MAPPED_FILE_USE_MMAP
+    void * _mapping;
+#endif
+    std::string _buffer;
+
+public:
+    explicit MappedFile(const std::filesystem::path & path)
+        : _data(nullptr)
+        , _size(0)
+#ifdef MAPPED_FILE_USE_MMAP
+        , _mapping(nullptr)
+#endif
+    {
+#ifdef MAPPED_FILE_USE_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd >= 0) {
+            struct stat st;
+            if(::fstat(fd, &st) == 0 && st.st_size > 0) {
+                _size = static_cast<std::size_t>(st.st_size);
+                void * mapping =
+                    ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(mapping != MAP_FAILED) {
+                    ::madvise(mapping, _size, MADV_SEQUENTIAL);
+                    _mapping = mapping;
+                    _data = static_cast<const char *>(mapping);
+                }
+            }
+            ::close(fd);
+            if(_mapping != nullptr) return;
+            _size = 0;
+        }
+#endif
+        std::ifstream file(path, std::ios::binary);
+        _buffer.assign(std::istreambuf_iterator<char>(file),
+                       std::istreambuf_iterator<char>());
+        _data = _buffer.data();
+        _size = _buffer.size();
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    ~MappedFile() {
+#ifdef MAPPED_FILE_USE_MMAP
+        if(_mapping != nullptr) ::munmap(_mapping, _size);
+#endif
+    }
+
+    const char * data() const { return _data; }
+    std::size_t size() const { return _size; }
+    std::string_view view() const { return std::string_view(_data, _size); }
+};
+
+#endif  // MAPPED_FILE_HPP
@@ -0,0 +1,288 @@
+/**
+ * @file pisinger_generator.hpp
+ * @brief Deterministic generator of the 0-1 knapsack instance classes of
+ * D. Pisinger, "Where are the hard knapsack problems?", Computers &
+ * Operations Research, 2005.
+ */
+#ifndef PISINGER_GENERATOR_HPP
+#define PISINGER_GENERATOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "utils/instance.hpp"
+
+enum class PisingerClass {
+    uncorrelated,
+    weakly_correlated,
+    strongly_correlated,
+    inverse_strongly_correlated,
+    almost_strongly_correlated,
+    subset_sum,
+    uncorrelated_spanner,
+    weakly_correlated_spanner,
+    strongly_correlated_spanner,
+    profit_ceiling,
+    circle
+};
+
+inline constexpr std::array<std::pair<PisingerClass, std::string_view>, 11>
+    pisinger_class_names = {{
+        {PisingerClass::uncorrelated, "uncorrelated"},
+        {PisingerClass::weakly_correlated, "weakly_correlated"},
+        {PisingerClass::strongly_correlated, "strongly_correlated"},
+        {PisingerClass::inverse_strongly_correlated,
+         "inverse_strongly_correlated"},
+        {PisingerClass::almost_strongly_correlated,
+         "almost_strongly_correlated"},
+        {PisingerClass::subset_sum, "subset_sum"},
+        {PisingerClass::uncorrelated_spanner, "uncorrelated_spanner"},
+        {PisingerClass::weakly_correlated_spanner, "weakly_correlated_spanner"},
+        {PisingerClass::strongly_correlated_spanner,
+         "strongly_correlated_spanner"},
+        {PisingerClass::profit_ceiling, "profit_ceiling"},
+        {PisingerClass::circle, "circle"},
+    }};
+
+inline std::optional<PisingerClass> parse_pisinger_class(
+    const std::string_view name) {
+    for(auto && [c, c_name] : pisinger_class_names)
+        if(c_name == name) return c;
+    return std::nullopt;
+}
+
+/**
+ * @brief SplitMix64 generator with unbiased bounded draws, so that a seed
+ * gives the same instance on every platform, unlike the standard
+ * distributions whose algorithms are implementation defined.
+ */
+class SplitMix64 {
+private:
+    std::uint64_t _state;
+
+public:
+    explicit SplitMix64(std::uint64_t seed) : _state(seed) {}
+
+    std::uint64_t operator()() {
+        std::uint64_t z = (_state += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+
+    // uniform in [a, b]
+    std::int64_t uniform(const std::int64_t a, const std::int64_t b) {
+        const std::uint64_t range = static_cast<std::uint64_t>(b - a) + 1;
+        // rejecting the first 2^64 mod range draws removes the modulo bias
+        const std::uint64_t threshold = (0 - range) % range;
+        std::uint64_t x;
+        do {
+            x = (*this)();
+        } while(x < threshold);
+        return a + static_cast<std::int64_t>(x % range);
+    }
+};
+
+/**
+ * @brief Lazily generated instance : items() is a forward range that
+ * regenerates the items from the seed on each traversal, so that instances
+ * of any size can be fed to the solvers without being stored. The budget is
+ * the given ratio of the total cost.
+ */
+template <typename Value = int, typename Cost = int>
+class PisingerInstance {
+public:
+    using Item = typename Instance<Value, Cost>::Item;
+
+    static constexpr std::int64_t spanner_size = 2;
+    static constexpr std::int64_t spanner_max_multiplier = 10;
+    static constexpr std::int64_t profit_ceiling_divisor = 3;
+    static constexpr double circle_factor = 2.0 / 3.0;
+
+private:
+    PisingerClass _class;
+    std::size_t _nb_items;
+    std::int64_t _range;
+    std::uint64_t _seed;
+    std::vector<std::pair<std::int64_t, std::int64_t>> _spanner_items;
+    Cost _budget;
+
+    std::pair<std::int64_t, std::int64_t> generate_item(
+        SplitMix64 & rng, const PisingerClass item_class) const {
+        const std::int64_t R = _range;
+        std::int64_t value, cost;
+        switch(item_class) {
+            case PisingerClass::uncorrelated:
+                cost = rng.uniform(1, R);
+                value = rng.uniform(1, R);
+                break;
+            case PisingerClass::weakly_correlated:
+                cost = rng.uniform(1, R);
+                value = rng.uniform(std::max<std::int64_t>(1, cost - R / 10),
+                                    cost + R / 10);
+                break;
+            case PisingerClass::strongly_correlated:
+                cost = rng.uniform(1, R);
+                value = cost + R / 10;
+                break;
+            case PisingerClass::inverse_strongly_correlated:
+                value = rng.uniform(1, R);
+                cost = value + R / 10;
+                break;
+            case PisingerClass::almost_strongly_correlated:
+                cost = rng.uniform(1, R);
+                value = rng.uniform(cost + R / 10 - R / 500,
+                                    cost + R / 10 + R / 500);
+                break;
+            case PisingerClass::subset_sum:
+                cost = rng.uniform(1, R);
+                value = cost;
+                break;
+            case PisingerClass::profit_ceiling:
+                cost = rng.uniform(1, R);
+                value = profit_ceiling_divisor *
+                        ((cost + profit_ceiling_divisor - 1) /
+                         profit_ceiling_divisor);
+                break;
+            case PisingerClass::circle:
+                cost = rng.uniform(1, R);
+                value = static_cast<std::int64_t>(
+                    circle_factor *
+                    std::sqrt(4.0 * static_cast<double>(R) *
+                                  static_cast<double>(R) -
+                              static_cast<double>((cost - 2 * R) *
+                                                  (cost - 2 * R))));
+                break;
+            default: {  // spanner classes
+                const auto & [spanner_value, spanner_cost] =
+                    _spanner_items[static_cast<std::size_t>(
+                        rng.uniform(0, spanner_size - 1))];
+                const std::int64_t a =
+                    rng.uniform(1, spanner_max_multiplier);
+                value = a * spanner_value;
+                cost = a * spanner_cost;
+            }
+        }
+        return {value, cost};
+    }
+
+public:
+    class iterator {
+    private:
+        const PisingerInstance * _instance;
+        SplitMix64 _rng;
+        std::size_t _index;
+        Item _item;
+
+        void generate() {
+            if(_index >= _instance->_nb_items) return;
+            const auto [value, cost] =
+                _instance->generate_item(_rng, _instance->_class);
+            _item = Item(static_cast<Value>(value), static_cast<Cost>(cost));
+        }
+
+    public:
+        using value_type = Item;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        iterator() : _instance(nullptr), _rng(0), _index(0), _item(0, 0) {}
+        iterator(const PisingerInstance * instance, std::size_t index)
+            : _instance(instance)
+            , _rng(instance->_seed)
+            , _index(index)
+            , _item(0, 0) {
+            generate();
+        }
+
+        Item operator*() const { return _item; }
+        iterator & operator++() {
+            ++_index;
+            generate();
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator it = *this;
+            ++*this;
+            return it;
+        }
+        bool operator==(const iterator & other) const {
+            return _index == other._index;
+        }
+    };
+
+    // throws std::out_of_range if the budget does not fit in Cost
+    PisingerInstance(const PisingerClass instance_class,
+                     const std::size_t nb_items, const std::int64_t range,
+                     const double capacity_ratio, const std::uint64_t seed)
+        : _class(instance_class)
+        , _nb_items(nb_items)
+        , _range(range)
+        , _seed(seed)
+        , _budget(0) {
+        if(range < 1) throw std::out_of_range("range must be positive");
+        if(_class == PisingerClass::uncorrelated_spanner ||
+           _class == PisingerClass::weakly_correlated_spanner ||
+           _class == PisingerClass::strongly_correlated_spanner) {
+            const PisingerClass spanner_class =
+                _class == PisingerClass::uncorrelated_spanner
+                    ? PisingerClass::uncorrelated
+                : _class == PisingerClass::weakly_correlated_spanner
+                    ? PisingerClass::weakly_correlated
+                    : PisingerClass::strongly_correlated;
+            SplitMix64 rng(~seed);
+            for(std::int64_t k = 0; k < spanner_size; ++k) {
+                const auto [value, cost] = generate_item(rng, spanner_class);
+                _spanner_items.emplace_back(
+                    (2 * value + spanner_max_multiplier - 1) /
+                        spanner_max_multiplier,
+                    (2 * cost + spanner_max_multiplier - 1) /
+                        spanner_max_multiplier);
+            }
+        }
+
+        long double total_cost = 0;
+        for(const Item & i : items()) total_cost += i.cost;
+        const long double budget = std::floor(capacity_ratio * total_cost);
+        if(budget > static_cast<long double>(std::numeric_limits<Cost>::max()))
+            throw std::out_of_range("budget " + std::to_string(budget) +
+                                    " overflows the cost type");
+        _budget = static_cast<Cost>(budget);
+    }
+
+    Cost getBudget() const { return _budget; }
+    std::optional<Value> getKnownOptimum() const { return std::nullopt; }
+    std::size_t itemCount() const { return _nb_items; }
+
+    auto items() const {
+        return std::ranges::subrange(iterator(this, 0),
+                                     iterator(this, _nb_items), _nb_items);
+    }
+    auto valueMap() const {
+        return [](const Item & i) { return i.value; };
+    }
+    auto costMap() const {
+        return [](const Item & i) { return i.cost; };
+    }
+
+    Instance<Value, Cost> toInstance() const {
+        Instance<Value, Cost> instance;
+        instance.setBudget(_budget);
+        instance.reserveItems(_nb_items);
+        for(const Item & i : items()) instance.addItem(i.value, i.cost);
+        return instance;
+    }
+};
+
+#endif  // PISINGER_GENERATOR_HPP
@@ -2,7 +2,15 @@
 #define FHAMONIC_KNAPSACK_ALL_HPP
 
 #include "knapsack/knapsack_bnb.hpp"
+#include "knapsack/knapsack_bnb_batch.hpp"
 #include "knapsack/knapsack_dp.hpp"
+#include "knapsack/knapsack_solver.hpp"
+#include "knapsack/multidimensional_knapsack_bnb.hpp"
+#include "knapsack/multiple_choice_knapsack_dp.hpp"
+#include "knapsack/multiple_knapsack_bnb.hpp"
+#include "knapsack/small_knapsack_bnb.hpp"
+#include "knapsack/streaming_knapsack_bnb.hpp"
+#include "knapsack/subset_sum_dp.hpp"
 #include "knapsack/unbounded_knapsack_bnb.hpp"
 
 #endif  // FHAMONIC_KNAPSACK_ALL_HPP
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef FHAMONIC_KNAPSACK_ALLOCATOR_VECTOR_HPP
+#define FHAMONIC_KNAPSACK_ALLOCATOR_VECTOR_HPP
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fhamonic {
+namespace knapsack {
+namespace detail {
+
+// The solvers take one allocator A, e.g. std::allocator<std::byte> or
+// std::pmr::polymorphic_allocator<std::byte>, and rebind it for each of
+// their containers.
+template <typename T, typename A>
+using allocator_vector =
+    std::vector<T, typename std::allocator_traits<A>::template rebind_alloc<T>>;
+
+// Allocator adaptor whose value construction default-initializes, so that
+// resizing a vector of trivial elements does not write, and thus touch, the
+// new memory. Constant evaluation, that forbids placement new and reading
+// uninitialized values, value-initializes instead.
+template <typename T, typename A>
+class default_init_allocator
+    : public std::allocator_traits<A>::template rebind_alloc<T> {
+private:
+    using base = typename std::allocator_traits<A>::template rebind_alloc<T>;
+
+public:
+    template <typename U>
+    struct rebind {
+        using other = default_init_allocator<U, A>;
+    };
+
+    using base::base;
+    constexpr default_init_allocator(const A & other) noexcept : base(other) {}
+    template <typename U>
+    constexpr default_init_allocator(
+        const default_init_allocator<U, A> & other) noexcept
+        : base(static_cast<const typename std::allocator_traits<
+                   A>::template rebind_alloc<U> &>(other)) {}
+
+    template <typename U>
+    constexpr void construct(U * p) noexcept(
+        std::is_nothrow_default_constructible_v<U>) {
+        if(std::is_constant_evaluated())
+            std::construct_at(p);
+        else
+            ::new(static_cast<void *>(p)) U;
+    }
+    template <typename U, typename... Args>
+    constexpr void construct(U * p, Args &&... args) {
+        std::allocator_traits<base>::construct(static_cast<base &>(*this), p,
+                                               std::forward<Args>(args)...);
+    }
+};
+
+template <typename T, typename A>
+using uninitialized_vector = std::vector<T, default_init_allocator<T, A>>;
+
+}  // namespace detail
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_ALLOCATOR_VECTOR_HPP
@@ -0,0 +1,107 @@
+#ifndef FHAMONIC_KNAPSACK_HUGE_PAGES_HPP
+#define FHAMONIC_KNAPSACK_HUGE_PAGES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#define FHAMONIC_KNAPSACK_USE_MMAP
+#endif
+
+namespace fhamonic {
+namespace knapsack {
+
+inline constexpr std::size_t huge_page_size = std::size_t{1} << 21;
+
+namespace detail {
+
+// Asks the kernel to back the 2 MiB aligned part of [data, data + bytes) with
+// transparent huge pages. Only effective on pages not yet touched, so it is
+// called right after allocating.
+inline void advise_huge_pages(void * data, const std::size_t bytes) noexcept {
+#if defined(FHAMONIC_KNAPSACK_USE_MMAP) && defined(MADV_HUGEPAGE)
+    const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(data);
+    const std::uintptr_t aligned_begin =
+        (begin + huge_page_size - 1) & ~(huge_page_size - 1);
+    const std::uintptr_t aligned_end = (begin + bytes) & ~(huge_page_size - 1);
+    if(aligned_begin < aligned_end)
+        ::madvise(reinterpret_cast<void *>(aligned_begin),
+                  aligned_end - aligned_begin, MADV_HUGEPAGE);
+#else
+    (void)data;
+    (void)bytes;
+#endif
+}
+
+}  // namespace detail
+
+// Memory resource mapping the allocations of at least one huge page with
+// explicit huge pages (MAP_HUGETLB) when some are reserved, and with
+// transparent huge pages otherwise. Smaller allocations, and every allocation
+// on platforms without mmap, are forwarded to the upstream resource. Mapped
+// pages are zero and not touched before their first write, so that they land
+// on the NUMA node of the thread that writes them first.
+// Meant for the dynamic programming tables :
+//   huge_page_resource resource;
+//   knapsack_dp(budget, items, value_map, cost_map,
+//               std::pmr::polymorphic_allocator<std::byte>(&resource));
+class huge_page_resource : public std::pmr::memory_resource {
+private:
+    std::pmr::memory_resource * _upstream;
+
+    static std::size_t mapping_size(const std::size_t bytes) noexcept {
+        return (bytes + huge_page_size - 1) & ~(huge_page_size - 1);
+    }
+
+public:
+    explicit huge_page_resource(
+        std::pmr::memory_resource * upstream = std::pmr::get_default_resource())
+        : _upstream(upstream) {}
+
+private:
+    void * do_allocate(const std::size_t bytes,
+                       const std::size_t alignment) override {
+#ifdef FHAMONIC_KNAPSACK_USE_MMAP
+        if(bytes >= huge_page_size && alignment <= huge_page_size) {
+            const std::size_t size = mapping_size(bytes);
+            void * data = MAP_FAILED;
+#ifdef MAP_HUGETLB
+            data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+            if(data == MAP_FAILED) {
+                data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if(data == MAP_FAILED) throw std::bad_alloc();
+                detail::advise_huge_pages(data, size);
+            }
+            return data;
+        }
+#endif
+        return _upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void * data, const std::size_t bytes,
+                       const std::size_t alignment) override {
+#ifdef FHAMONIC_KNAPSACK_USE_MMAP
+        if(bytes >= huge_page_size && alignment <= huge_page_size) {
+            ::munmap(data, mapping_size(bytes));
+            return;
+        }
+#endif
+        _upstream->deallocate(data, bytes, alignment);
+    }
+
+    bool do_is_equal(
+        const std::pmr::memory_resource & other) const noexcept override {
+        return this == &other;
+    }
+};
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_HUGE_PAGES_HPP
@@ -0,0 +1,73 @@
+#ifndef FHAMONIC_KNAPSACK_INTEGER_RATIO_HPP
+#define FHAMONIC_KNAPSACK_INTEGER_RATIO_HPP
+
+#include <concepts>
+#include <cstdint>
+#include <type_traits>
+
+namespace fhamonic {
+namespace knapsack {
+namespace detail {
+
+#ifdef __SIZEOF_INT128__
+__extension__ typedef __int128 int128_t;
+__extension__ typedef unsigned __int128 uint128_t;
+#endif
+
+// Integer type holding the product of a value and a cost, void if none does.
+template <typename V, typename C>
+struct product {
+    using type = void;
+};
+template <std::integral V, std::integral C>
+    requires(sizeof(V) <= 4 && sizeof(C) <= 4)
+struct product<V, C> {
+    using type = std::conditional_t<std::is_signed_v<V> || std::is_signed_v<C>,
+                                    std::int64_t, std::uint64_t>;
+};
+#ifdef __SIZEOF_INT128__
+template <std::integral V, std::integral C>
+    requires((sizeof(V) > 4 || sizeof(C) > 4) && sizeof(V) <= 8 &&
+             sizeof(C) <= 8)
+struct product<V, C> {
+    using type = std::conditional_t<std::is_signed_v<V> || std::is_signed_v<C>,
+                                    int128_t, uint128_t>;
+};
+#endif
+template <typename V, typename C>
+using product_t = typename product<V, C>::type;
+
+// With integral values and costs, the value/cost ratios are compared by
+// cross-multiplication and the fractional item of the upper bounds is
+// floored by an integer division, exactly, instead of through doubles whose
+// rounding can order equal ratios arbitrarily or prune an optimal branch
+// once the values exceed 2^53.
+template <typename V, typename C>
+inline constexpr bool exact_ratios = !std::is_void_v<product_t<V, C>>;
+
+// value1 / cost1 > value2 / cost2, a cost of 0 being an infinite ratio
+template <typename V, typename C>
+    requires exact_ratios<V, C>
+constexpr bool higher_ratio(const V value1, const C cost1, const V value2,
+                            const C cost2) noexcept {
+    using P = product_t<V, C>;
+    return static_cast<P>(value1) * static_cast<P>(cost2) >
+           static_cast<P>(value2) * static_cast<P>(cost1);
+}
+
+// floor(budget * value / cost) for a budget lower than the cost, thus a
+// result lower than the value
+template <typename V, typename C>
+    requires exact_ratios<V, C>
+constexpr V fractional_value(const C budget, const V value,
+                             const C cost) noexcept {
+    using P = product_t<V, C>;
+    return static_cast<V>(static_cast<P>(budget) * static_cast<P>(value) /
+                          static_cast<P>(cost));
+}
+
+}  // namespace detail
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_INTEGER_RATIO_HPP
@@ -1,148 +1,741 @@
 #ifndef FHAMONIC_KNAPSACK_BRANCH_AND_BOUND_HPP
 #define FHAMONIC_KNAPSACK_BRANCH_AND_BOUND_HPP
 
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <future>
-#include <iterator>
+#include <limits>
 #include <numeric>
+#include <queue>
 #include <ranges>
+#include <stop_token>
 #include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
-#include <range/v3/algorithm/sort.hpp>
-#include <range/v3/view/transform.hpp>
-#include <range/v3/view/zip.hpp>
+#include "knapsack/allocator_vector.hpp"
+#include "knapsack/integer_ratio.hpp"
+#include "knapsack/lp_bound.hpp"
 
 namespace fhamonic {
 namespace knapsack {
 
-template <typename C, typename RI, typename VM, typename CM>
+enum class search_strategy {
+    // explores the take branch first, in memory proportional to the number
+    // of items
+    depth_first,
+    // expands the open node of highest upper bound, branching on one item
+    best_first,
+    // dives depth-first from the open node of highest upper bound to a leaf,
+    // storing the skip branches as open nodes, then restarts from the best
+    hybrid
+};
+
+// A is rebound for every internal container, search stack included
+template <typename C, typename RI, typename VM, typename CM,
+          typename A = std::allocator<std::byte>>
 class knapsack_bnb {
 private:
     using I = std::ranges::range_value_t<RI>;
     using V = std::invoke_result_t<VM, I>;
+    template <typename T>
+    using vector = detail::allocator_vector<T, A>;
 
     C _budget;
-    std::vector<I> _permuted_items;
-    std::vector<std::pair<V, C>> _value_cost_pairs;
-    std::vector<typename std::vector<std::pair<V, C>>::const_iterator>
-        _best_sol;
+    // items sorted by decreasing value/cost ratio, stored as separate arrays
+    // so that the bound computations stream contiguous values and costs
+    vector<I> _permuted_items;
+    vector<V> _values;
+    vector<C> _costs;
+    vector<std::uint32_t> _best_sol;
+    // Items are identified by their position in the item range, or by the
+    // position returned by add_item(). _positions gives the position of each
+    // sorted item and _sorted_indices the sorted index of each position, or
+    // no_index if the item is excluded or removed.
+    vector<std::uint32_t> _positions;
+    vector<std::uint32_t> _sorted_indices;
+    // items of value 0 or cost above the budget, kept for the updates
+    struct excluded_item {
+        I item;
+        V value;
+        C cost;
+        std::uint32_t position;
+    };
+    vector<excluded_item> _excluded_items;
+    // positions of the warm start solution
+    vector<std::uint32_t> _warm_start;
+    // Search stack of the sorted indices of the taken items, sized to the
+    // number of items before each search and indexed by the search depth, so
+    // that the hot loops neither check nor grow its capacity.
+    vector<std::uint32_t> _trail;
+    // reset() scratch buffers, kept to reuse their capacity
+    vector<I> _filtered_items;
+    vector<V> _filtered_values;
+    vector<C> _filtered_costs;
+    vector<std::uint32_t> _filtered_positions;
+    vector<double> _ratios;
+    vector<std::uint32_t> _permutation;
+    vector<char> _taken;
+
+    // node of the best-first searches, the items before first_item are
+    // decided and the taken ones are linked from trail
+    struct open_node {
+        V upper_bound;
+        V value;
+        C budget_left;
+        std::uint32_t first_item;
+        std::uint32_t trail;
+    };
+    static constexpr std::uint32_t no_trail =
+        std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint32_t no_index =
+        std::numeric_limits<std::uint32_t>::max();
+
+    // number of items on each side of the critical one considered by the
+    // local search of primal_heuristic()
+    static constexpr std::uint32_t local_search_window = 16;
 
 private:
-    double value_cost_ratio(const std::pair<V, C> & p) const noexcept {
+    static constexpr double value_cost_ratio(const V value,
+                                             const C cost) noexcept {
         if constexpr(std::numeric_limits<float>::is_iec559) {
-            return p.first / static_cast<double>(p.second);
+            return value / static_cast<double>(cost);
         } else {
-            return (p.second == 0) ? std::numeric_limits<double>::max()
-                                   : (p.first / static_cast<double>(p.second));
+            return (cost == 0) ? std::numeric_limits<double>::max()
+                               : (value / static_cast<double>(cost));
         }
     }
 
-    V computeUpperBound(auto it, const auto end, V bound_value,
-                        C bound_budget_left) const noexcept {
-        for(; it < end; ++it) {
-            if(bound_budget_left < it->second)
-                return static_cast<V>(bound_value +
-                                      bound_budget_left * it->first /
-                                          static_cast<double>(it->second));
-            bound_budget_left -= it->second;
-            bound_value += it->first;
+    constexpr V computeUpperBound(const std::size_t i, const V bound_value,
+                                  const C bound_budget_left) const noexcept {
+        return detail::lp_bound(_values.data(), _costs.data(), i,
+                                _values.size(), bound_value,
+                                bound_budget_left);
+    }
+
+    // Greedy solution by decreasing ratio, or the most valuable item if
+    // better, improved by exchanging one or two taken items for an untaken
+    // one, among the items around the critical one, followed by a greedy
+    // refill. Stores it in _best_sol and returns its value.
+    constexpr V primal_heuristic() noexcept {
+        const std::uint32_t nb_items =
+            static_cast<std::uint32_t>(_values.size());
+        _taken.assign(nb_items, 0);
+        V value = 0;
+        C budget_left = _budget;
+        auto take = [&](const std::uint32_t i) {
+            _taken[i] = 1;
+            value += _values[i];
+            budget_left -= _costs[i];
+        };
+        auto untake = [&](const std::uint32_t i) {
+            _taken[i] = 0;
+            value -= _values[i];
+            budget_left += _costs[i];
+        };
+        auto fill = [&] {
+            for(std::uint32_t i = 0; i < nb_items; ++i)
+                if(!_taken[i] && _costs[i] <= budget_left) take(i);
+        };
+        fill();
+
+        std::uint32_t critical = 0;
+        while(critical < nb_items && _taken[critical]) ++critical;
+        const std::uint32_t first =
+            critical > local_search_window ? critical - local_search_window
+                                           : 0;
+        const std::uint32_t last =
+            std::min(nb_items, critical + local_search_window);
+        // each exchange strictly increases the value
+        auto exchange = [&]() {
+            for(std::uint32_t in = first; in < last; ++in) {
+                if(_taken[in]) continue;
+                for(std::uint32_t out = first; out < last; ++out) {
+                    if(!_taken[out]) continue;
+                    if(_costs[in] <= budget_left + _costs[out] &&
+                       _values[in] > _values[out]) {
+                        untake(out);
+                        take(in);
+                        return true;
+                    }
+                    for(std::uint32_t out2 = out + 1; out2 < last; ++out2) {
+                        if(!_taken[out2]) continue;
+                        if(_costs[in] <=
+                               budget_left + _costs[out] + _costs[out2] &&
+                           _values[in] > _values[out] + _values[out2]) {
+                            untake(out);
+                            untake(out2);
+                            take(in);
+                            return true;
+                        }
+                    }
+                }
+            }
+            return false;
+        };
+        while(exchange()) fill();
+
+        _best_sol.resize(0);
+        std::uint32_t best_item = 0;
+        for(std::uint32_t i = 0; i < nb_items; ++i) {
+            if(_taken[i]) _best_sol.push_back(i);
+            if(_values[i] > _values[best_item]) best_item = i;
+        }
+        if(nb_items > 0 && _values[best_item] > value) {
+            _best_sol.assign(1, best_item);
+            value = _values[best_item];
         }
+        return value;
+    }
 
-        return bound_value;
+    // Initial incumbent of the searches, the best of the primal heuristic
+    // and of the warm start. The items of the warm start may have changed
+    // since it was given, so it is repaired by removing its items of lowest
+    // ratio until it fits in the budget.
+    constexpr V initial_incumbent() noexcept {
+        const V heuristic_value = primal_heuristic();
+        const std::uint32_t nb_items =
+            static_cast<std::uint32_t>(_values.size());
+        _taken.assign(nb_items, 0);
+        for(const std::uint32_t position : _warm_start) {
+            const std::uint32_t i = _sorted_indices[position];
+            if(i != no_index) _taken[i] = 1;
+        }
+        V value = 0;
+        C cost = 0;
+        for(std::uint32_t i = 0; i < nb_items; ++i) {
+            if(!_taken[i]) continue;
+            value += _values[i];
+            cost += _costs[i];
+        }
+        std::uint32_t end = nb_items;
+        while(cost > _budget) {
+            if(!_taken[--end]) continue;
+            value -= _values[end];
+            cost -= _costs[end];
+        }
+        if(value <= heuristic_value) return heuristic_value;
+        _best_sol.resize(0);
+        for(std::uint32_t i = 0; i < end; ++i)
+            if(_taken[i]) _best_sol.push_back(i);
+        return value;
     }
 
-    void iterative_bnb() noexcept {
+    // The updates change the sorted indices, so the last solution is kept,
+    // by positions, as warm start of the next solve.
+    constexpr void keep_solution_as_warm_start() noexcept {
+        if(_best_sol.empty()) return;
+        _warm_start.resize(0);
+        for(const std::uint32_t i : _best_sol)
+            _warm_start.push_back(_positions[i]);
         _best_sol.resize(0);
-        auto it = _value_cost_pairs.cbegin();
-        const auto end = _value_cost_pairs.cend();
-        if(it == end) return;
-        std::vector<decltype(it)> current_sol;
-        V current_sol_value = 0;
-        V best_sol_value = 0;
-        C budget_left = _budget;
-        goto begin;
-    backtrack:
-        while(!current_sol.empty()) {
-            it = current_sol.back();
-            current_sol_value -= it->first;
-            budget_left += it->second;
-            current_sol.pop_back();
-            for(++it; it < end; ++it) {
-                if(budget_left < it->second) continue;
-                if(computeUpperBound(it, end, current_sol_value, budget_left) <=
+    }
+
+    // inserts the item at its place in the ratio order, or among the
+    // excluded items
+    constexpr void insert_item(I item, const V value, const C cost,
+                               const std::uint32_t position) noexcept {
+        if(value == static_cast<V>(0) || cost > _budget) {
+            _sorted_indices[position] = no_index;
+            _excluded_items.push_back({std::move(item), value, cost, position});
+            return;
+        }
+        // first item of ratio lower than the inserted one
+        std::uint32_t first = 0;
+        std::uint32_t last = static_cast<std::uint32_t>(_values.size());
+        while(first < last) {
+            const std::uint32_t middle = first + (last - first) / 2;
+            bool lower;
+            if constexpr(detail::exact_ratios<V, C>)
+                lower = detail::higher_ratio(value, cost, _values[middle],
+                                             _costs[middle]);
+            else
+                lower = value_cost_ratio(value, cost) >
+                        value_cost_ratio(_values[middle], _costs[middle]);
+            if(lower)
+                last = middle;
+            else
+                first = middle + 1;
+        }
+        const std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(first);
+        _permuted_items.insert(_permuted_items.begin() + offset,
+                               std::move(item));
+        _values.insert(_values.begin() + offset, value);
+        _costs.insert(_costs.begin() + offset, cost);
+        _positions.insert(_positions.begin() + offset, position);
+        for(std::uint32_t i = first; i < _positions.size(); ++i)
+            _sorted_indices[_positions[i]] = i;
+    }
+
+    // whether the position is one of an item, neither out of range nor
+    // removed
+    constexpr bool has_item(const std::size_t position) const noexcept {
+        if(position >= _sorted_indices.size()) return false;
+        if(_sorted_indices[position] != no_index) return true;
+        return std::ranges::find(_excluded_items, position,
+                                 &excluded_item::position) !=
+               _excluded_items.end();
+    }
+
+    // removes the item of the given position, that must satisfy has_item(),
+    // from the sorted or excluded items and returns it
+    constexpr excluded_item extract_item(
+        const std::uint32_t position) noexcept {
+        const std::uint32_t k = _sorted_indices[position];
+        if(k == no_index) {
+            auto it = std::ranges::find(_excluded_items, position,
+                                        &excluded_item::position);
+            excluded_item extracted = std::move(*it);
+            _excluded_items.erase(it);
+            return extracted;
+        }
+        excluded_item extracted{std::move(_permuted_items[k]), _values[k],
+                                _costs[k], position};
+        const std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(k);
+        _permuted_items.erase(_permuted_items.begin() + offset);
+        _values.erase(_values.begin() + offset);
+        _costs.erase(_costs.begin() + offset);
+        _positions.erase(_positions.begin() + offset);
+        _sorted_indices[position] = no_index;
+        for(std::uint32_t i = k; i < _positions.size(); ++i)
+            _sorted_indices[_positions[i]] = i;
+        return extracted;
+    }
+
+    // Copies into _best_sol the items of the trail from divergence, the size
+    // of their common prefix, to depth, so that an improvement costs the
+    // depth changed since the previous one instead of the whole stack.
+    constexpr void copy_changed_suffix(const std::size_t depth,
+                                       std::size_t & divergence) noexcept {
+        _best_sol.resize(divergence);
+        _best_sol.insert(
+            _best_sol.end(),
+            _trail.begin() + static_cast<std::ptrdiff_t>(divergence),
+            _trail.begin() + static_cast<std::ptrdiff_t>(depth));
+        divergence = depth;
+    }
+
+    // Explores the subtree of the items from i given the depth items taken
+    // before, stored in the trail, of total value current_sol_value.
+    // keeps _best_sol if no solution better than best_sol_value is found
+    // Written without goto, that constant evaluation forbids : a pruned
+    // descent falls through the improvement test since its value is at most
+    // its bound.
+    constexpr V iterative_bnb(std::uint32_t i, std::size_t depth,
+                              V current_sol_value, C budget_left,
+                              V best_sol_value) noexcept {
+        const std::uint32_t nb_items =
+            static_cast<std::uint32_t>(_values.size());
+        while(i < nb_items && budget_left < _costs[i]) ++i;
+        if(i == nb_items) return best_sol_value;
+        _trail.resize(nb_items);
+        std::uint32_t * const trail = _trail.data();
+        const std::size_t prefix_size = depth;
+        // _best_sol and the trail share their first divergence items
+        std::size_t divergence = 0;
+        current_sol_value += _values[i];
+        budget_left -= _costs[i];
+        trail[depth++] = i;
+        for(;;) {
+            for(++i; i < nb_items; ++i) {
+                if(budget_left < _costs[i]) continue;
+                if(computeUpperBound(i, current_sol_value, budget_left) <=
                    best_sol_value)
-                    goto backtrack;
-            begin:
-                current_sol_value += it->first;
-                budget_left -= it->second;
-                current_sol.push_back(it);
+                    break;
+                current_sol_value += _values[i];
+                budget_left -= _costs[i];
+                trail[depth++] = i;
             }
-            if(current_sol_value <= best_sol_value) continue;
-            best_sol_value = current_sol_value;
-            _best_sol = current_sol;
+            if(current_sol_value > best_sol_value) {
+                best_sol_value = current_sol_value;
+                copy_changed_suffix(depth, divergence);
+            }
+            if(depth == prefix_size) break;
+            i = trail[--depth];
+            current_sol_value -= _values[i];
+            budget_left += _costs[i];
+            divergence = std::min(divergence, depth);
         }
+        return best_sol_value;
     }
     bool iterative_bnb_timeout(std::stop_token stoken) noexcept {
-        _best_sol.resize(0);
-        auto it = _value_cost_pairs.cbegin();
-        const auto end = _value_cost_pairs.cend();
-        if(it == end) return true;
-        std::vector<decltype(it)> current_sol;
+        V best_sol_value = initial_incumbent();
+        const std::uint32_t nb_items =
+            static_cast<std::uint32_t>(_values.size());
+        if(nb_items == 0) return true;
+        std::uint32_t i = 0;
+        _trail.resize(nb_items);
+        std::uint32_t * const trail = _trail.data();
+        std::size_t depth = 0;
         V current_sol_value = 0;
-        V best_sol_value = 0;
         C budget_left = _budget;
+        std::size_t divergence = 0;
         goto begin;
     backtrack:
-        while(!current_sol.empty() && !stoken.stop_requested()) {
-            it = current_sol.back();
-            current_sol_value -= it->first;
-            budget_left += it->second;
-            current_sol.pop_back();
-            for(++it; it < end; ++it) {
-                if(budget_left < it->second) continue;
-                if(computeUpperBound(it, end, current_sol_value, budget_left) <=
+        while(depth > 0 && !stoken.stop_requested()) {
+            i = trail[--depth];
+            current_sol_value -= _values[i];
+            budget_left += _costs[i];
+            divergence = std::min(divergence, depth);
+            for(++i; i < nb_items; ++i) {
+                if(budget_left < _costs[i]) continue;
+                if(computeUpperBound(i, current_sol_value, budget_left) <=
                    best_sol_value)
                     goto backtrack;
             begin:
-                current_sol_value += it->first;
-                budget_left -= it->second;
-                current_sol.push_back(it);
+                current_sol_value += _values[i];
+                budget_left -= _costs[i];
+                trail[depth++] = i;
             }
             if(current_sol_value <= best_sol_value) continue;
             best_sol_value = current_sol_value;
-            _best_sol = current_sol;
+            copy_changed_suffix(depth, divergence);
+        }
+        return depth == 0;
+    }
+
+    // Best-first and hybrid searches. Once max_nodes open nodes and trail
+    // entries are stored, the subtrees of the next open nodes are explored
+    // depth-first.
+    V best_first_search(const search_strategy strategy,
+                        const std::size_t max_nodes) noexcept {
+        const std::uint32_t nb_items =
+            static_cast<std::uint32_t>(_values.size());
+        // pairs of previous trail entry and taken item
+        vector<std::pair<std::uint32_t, std::uint32_t>> trail(get_allocator());
+        auto lower_bound = [](const open_node & a, const open_node & b) {
+            return a.upper_bound < b.upper_bound;
+        };
+        std::priority_queue<open_node, vector<open_node>, decltype(lower_bound)>
+            open_nodes(lower_bound, vector<open_node>(get_allocator()));
+        V best_sol_value = initial_incumbent();
+
+        auto trail_items = [&trail](std::uint32_t t, auto & items) {
+            items.resize(0);
+            for(; t != no_trail; t = trail[t].first)
+                items.push_back(trail[t].second);
+        };
+        auto push = [&](const std::uint32_t i, const V value,
+                        const C budget_left, const std::uint32_t t) {
+            const V upper_bound = computeUpperBound(i, value, budget_left);
+            if(upper_bound > best_sol_value)
+                open_nodes.push({upper_bound, value, budget_left, i, t});
+        };
+
+        push(0, 0, _budget, no_trail);
+        while(!open_nodes.empty()) {
+            const open_node node = open_nodes.top();
+            open_nodes.pop();
+            if(node.upper_bound <= best_sol_value) break;
+            if(open_nodes.size() + trail.size() >= max_nodes) {
+                _trail.resize(nb_items);
+                std::size_t depth = 0;
+                for(std::uint32_t t = node.trail; t != no_trail;
+                    t = trail[t].first)
+                    _trail[depth++] = trail[t].second;
+                best_sol_value =
+                    iterative_bnb(node.first_item, depth, node.value,
+                                  node.budget_left, best_sol_value);
+                continue;
+            }
+            V value = node.value;
+            C budget_left = node.budget_left;
+            std::uint32_t t = node.trail;
+            for(std::uint32_t i = node.first_item; i < nb_items; ++i) {
+                if(budget_left < _costs[i]) continue;
+                push(i + 1, value, budget_left, t);  // skip item i
+                trail.emplace_back(t, i);
+                t = static_cast<std::uint32_t>(trail.size() - 1);
+                value += _values[i];
+                budget_left -= _costs[i];
+                if(strategy == search_strategy::best_first) {
+                    push(i + 1, value, budget_left, t);
+                    break;
+                }
+            }
+            if(value <= best_sol_value) continue;
+            best_sol_value = value;
+            trail_items(t, _best_sol);
         }
-        return current_sol.empty();
+        return best_sol_value;
     }
 
 public:
-    knapsack_bnb(const C budget, const RI & items, const VM & value_map,
-                 const CM & cost_map) noexcept
-        : _budget(budget) {
+    // empty solver, meant to be reset() with an instance
+    constexpr explicit knapsack_bnb(const A & allocator = A()) noexcept
+        : _budget(0)
+        , _permuted_items(allocator)
+        , _values(allocator)
+        , _costs(allocator)
+        , _best_sol(allocator)
+        , _positions(allocator)
+        , _sorted_indices(allocator)
+        , _excluded_items(allocator)
+        , _warm_start(allocator)
+        , _trail(allocator)
+        , _filtered_items(allocator)
+        , _filtered_values(allocator)
+        , _filtered_costs(allocator)
+        , _filtered_positions(allocator)
+        , _ratios(allocator)
+        , _permutation(allocator)
+        , _taken(allocator) {}
+
+    constexpr knapsack_bnb(const C budget, const RI & items,
+                           const VM & value_map, const CM & cost_map,
+                           const A & allocator = A()) noexcept
+        : knapsack_bnb(allocator) {
+        reset(budget, items, value_map, cost_map);
+    }
+
+    constexpr A get_allocator() const noexcept {
+        return A(_values.get_allocator());
+    }
+
+    // Replaces the instance, reusing the capacity of every buffer so that
+    // solving a stream of instances of similar sizes stops allocating.
+    constexpr void reset(const C budget, const RI & items,
+                         const VM & value_map, const CM & cost_map) noexcept {
+        _budget = budget;
+        _filtered_items.clear();
+        _filtered_values.clear();
+        _filtered_costs.clear();
+        _filtered_positions.clear();
         if constexpr(std::ranges::sized_range<RI>) {
-            _permuted_items.reserve(std::ranges::size(items));
-            _value_cost_pairs.reserve(std::ranges::size(items));
+            const std::size_t nb_items = std::ranges::size(items);
+            _filtered_items.reserve(nb_items);
+            _filtered_values.reserve(nb_items);
+            _filtered_costs.reserve(nb_items);
+            _filtered_positions.reserve(nb_items);
         }
 
+        _excluded_items.clear();
+        std::uint32_t position = 0;
         for(auto && i : items) {
             const V value = value_map(i);
-            if(value == static_cast<V>(0)) continue;
             const C cost = cost_map(i);
-            if(cost > _budget) continue;
-            _permuted_items.emplace_back(i);
-            _value_cost_pairs.emplace_back(value, cost);
+            if(value == static_cast<V>(0) || cost > _budget) {
+                _excluded_items.push_back({i, value, cost, position++});
+                continue;
+            }
+            _filtered_items.emplace_back(i);
+            _filtered_values.emplace_back(value);
+            _filtered_costs.emplace_back(cost);
+            _filtered_positions.emplace_back(position++);
         }
 
-        auto zip_view = ranges::view::zip(_value_cost_pairs, _permuted_items);
-        ranges::sort(zip_view, [this](auto p1, auto p2) {
-            return value_cost_ratio(p1.first) > value_cost_ratio(p2.first);
-        });
+        const std::size_t nb_items = _filtered_values.size();
+        _permutation.resize(nb_items);
+        std::iota(_permutation.begin(), _permutation.end(), std::uint32_t{0});
+        if constexpr(detail::exact_ratios<V, C>) {
+            std::ranges::sort(_permutation, [this](std::uint32_t i,
+                                                   std::uint32_t j) {
+                return detail::higher_ratio(
+                    _filtered_values[i], _filtered_costs[i],
+                    _filtered_values[j], _filtered_costs[j]);
+            });
+        } else {
+            _ratios.resize(nb_items);
+            for(std::size_t i = 0; i < nb_items; ++i)
+                _ratios[i] =
+                    value_cost_ratio(_filtered_values[i], _filtered_costs[i]);
+            std::ranges::sort(_permutation,
+                              [this](std::uint32_t i, std::uint32_t j) {
+                                  return _ratios[i] > _ratios[j];
+                              });
+        }
+        _permuted_items.clear();
+        _values.clear();
+        _costs.clear();
+        _positions.clear();
+        _permuted_items.reserve(nb_items);
+        _values.reserve(nb_items);
+        _costs.reserve(nb_items);
+        _positions.reserve(nb_items);
+        for(const std::uint32_t i : _permutation) {
+            _permuted_items.emplace_back(std::move(_filtered_items[i]));
+            _values.emplace_back(_filtered_values[i]);
+            _costs.emplace_back(_filtered_costs[i]);
+            _positions.emplace_back(_filtered_positions[i]);
+        }
+        _sorted_indices.assign(position, no_index);
+        for(std::uint32_t i = 0; i < nb_items; ++i)
+            _sorted_indices[_positions[i]] = i;
+        _warm_start.clear();
+        _best_sol.clear();
+        _best_sol.reserve(nb_items);
+        _trail.reserve(nb_items);
     }
 
-    void solve() noexcept { iterative_bnb(); }
+    // Known feasible solution, given by the positions of its items in the
+    // item range, used with the primal heuristic to seed the incumbent of
+    // the next solves. Its items of value 0 or cost above the budget, and
+    // repeated positions, are ignored. Returns false, and keeps no warm
+    // start, if a position is out of range or if the budget is exceeded.
+    template <std::ranges::input_range R>
+    constexpr bool warm_start(const R & positions) noexcept {
+        _warm_start.resize(0);
+        _taken.assign(_values.size(), 0);
+        C cost = 0;
+        for(auto && p : positions) {
+            const std::size_t position = static_cast<std::size_t>(p);
+            if(position >= _sorted_indices.size()) {
+                _warm_start.resize(0);
+                return false;
+            }
+            const std::uint32_t i = _sorted_indices[position];
+            if(i == no_index || _taken[i]) continue;
+            _taken[i] = 1;
+            cost += _costs[i];
+            if(cost > _budget) {
+                _warm_start.resize(0);
+                return false;
+            }
+            _warm_start.push_back(static_cast<std::uint32_t>(position));
+        }
+        return true;
+    }
+
+    // Incremental updates, that keep the items sorted by moving only the
+    // updated ones, in time linear in the number of items instead of
+    // sorting them again. The next solve starts from the last solution,
+    // repaired if it no longer fits, and solution() is empty until then.
+    // update_item() and remove_item() return false, and change nothing, if
+    // the position is out of range or of a removed item.
+
+    // the item of the given position is replaced
+    constexpr bool update_item(const std::size_t position, const I & item,
+                               const VM & value_map,
+                               const CM & cost_map) noexcept {
+        if(!has_item(position)) return false;
+        keep_solution_as_warm_start();
+        const std::uint32_t p = static_cast<std::uint32_t>(position);
+        extract_item(p);
+        insert_item(item, value_map(item), cost_map(item), p);
+        return true;
+    }
+
+    // returns the position of the new item
+    constexpr std::size_t add_item(const I & item, const VM & value_map,
+                                   const CM & cost_map) noexcept {
+        keep_solution_as_warm_start();
+        const std::uint32_t p =
+            static_cast<std::uint32_t>(_sorted_indices.size());
+        _sorted_indices.push_back(no_index);
+        insert_item(item, value_map(item), cost_map(item), p);
+        return p;
+    }
+
+    // the position is not reused
+    constexpr bool remove_item(const std::size_t position) noexcept {
+        if(!has_item(position)) return false;
+        keep_solution_as_warm_start();
+        extract_item(static_cast<std::uint32_t>(position));
+        return true;
+    }
+
+    constexpr void set_budget(const C budget) noexcept {
+        keep_solution_as_warm_start();
+        const bool decreased = budget < _budget;
+        _budget = budget;
+        if(decreased) {
+            // the items that no longer fit are moved to the excluded ones in
+            // one pass that compacts the others, keeping their order
+            const std::uint32_t nb_items =
+                static_cast<std::uint32_t>(_costs.size());
+            std::uint32_t nb_kept = 0;
+            for(std::uint32_t i = 0; i < nb_items; ++i) {
+                if(_costs[i] > _budget) {
+                    _sorted_indices[_positions[i]] = no_index;
+                    _excluded_items.push_back({std::move(_permuted_items[i]),
+                                               _values[i], _costs[i],
+                                               _positions[i]});
+                    continue;
+                }
+                if(nb_kept != i) {
+                    _permuted_items[nb_kept] = std::move(_permuted_items[i]);
+                    _values[nb_kept] = _values[i];
+                    _costs[nb_kept] = _costs[i];
+                    _positions[nb_kept] = _positions[i];
+                }
+                _sorted_indices[_positions[nb_kept]] = nb_kept;
+                ++nb_kept;
+            }
+            const std::ptrdiff_t end = static_cast<std::ptrdiff_t>(nb_kept);
+            _permuted_items.erase(_permuted_items.begin() + end,
+                                  _permuted_items.end());
+            _values.erase(_values.begin() + end, _values.end());
+            _costs.erase(_costs.begin() + end, _costs.end());
+            _positions.erase(_positions.begin() + end, _positions.end());
+            return;
+        }
+        for(std::size_t k = _excluded_items.size(); k-- > 0;) {
+            if(_excluded_items[k].value == static_cast<V>(0) ||
+               _excluded_items[k].cost > _budget)
+                continue;
+            excluded_item item = std::move(_excluded_items[k]);
+            _excluded_items.erase(_excluded_items.begin() +
+                                  static_cast<std::ptrdiff_t>(k));
+            insert_item(std::move(item.item), item.value, item.cost,
+                        item.position);
+        }
+    }
+
+    constexpr void solve() noexcept {
+        iterative_bnb(0, 0, 0, _budget, initial_incumbent());
+    }
+
+    // max_nodes bounds the number of nodes stored by the best-first and
+    // hybrid strategies, beyond which they continue depth-first
+    void solve(const search_strategy strategy,
+               const std::size_t max_nodes = std::size_t{1} << 22) noexcept {
+        if(strategy == search_strategy::depth_first) {
+            solve();
+            return;
+        }
+        _best_sol.resize(0);
+        best_first_search(strategy, max_nodes);
+    }
+
+    // Optimal values for each of the given budgets, those above the
+    // constructor one being lowered to it since the items of higher cost are
+    // excluded. The budgets are solved by increasing order reusing the sorted
+    // items, each search starting with the previous optimum as incumbent
+    // since it remains feasible. solution() is then the one of the largest
+    // budget.
+    template <std::ranges::input_range RB>
+    constexpr std::vector<V> value_profile(const RB & budgets) noexcept {
+        vector<C> clamped_budgets(get_allocator());
+        for(auto && budget : budgets)
+            clamped_budgets.push_back(
+                std::min(static_cast<C>(budget), _budget));
+        vector<std::size_t> budgets_indices(clamped_budgets.size(),
+                                            get_allocator());
+        std::iota(budgets_indices.begin(), budgets_indices.end(),
+                  std::size_t{0});
+        std::ranges::sort(budgets_indices,
+                          [&clamped_budgets](std::size_t i, std::size_t j) {
+                              return clamped_budgets[i] < clamped_budgets[j];
+                          });
+        std::vector<V> values(clamped_budgets.size());
+        V best_sol_value = 0;
+        _best_sol.resize(0);
+        for(const std::size_t i : budgets_indices) {
+            best_sol_value =
+                iterative_bnb(0, 0, 0, clamped_budgets[i], best_sol_value);
+            values[i] = best_sol_value;
+        }
+        return values;
+    }
+
+    // returns false if stopped before the end, solution() is then the best
+    // solution found
+    bool solve(std::stop_token stoken) noexcept {
+        return iterative_bnb_timeout(stoken);
+    }
 
     template <typename _Rep, typename _Period>
     bool solve(const std::chrono::duration<_Rep, _Period> & timeout) noexcept {
@@ -163,11 +756,24 @@ public:
         return true;
     }
 
-    auto solution() const noexcept {
-        return std::ranges::views::transform(_best_sol, [this](auto && it) {
-            return _permuted_items[static_cast<std::size_t>(
-                std::distance(_value_cost_pairs.cbegin(), it))];
-        });
+    // solution as a bitset indexed by the positions of the items in the item
+    // range, or returned by add_item()
+    constexpr std::vector<bool> solution_bitset() const {
+        std::vector<bool> taken(_sorted_indices.size(), false);
+        for(const std::uint32_t i : _best_sol) taken[_positions[i]] = true;
+        return taken;
+    }
+
+    constexpr V solution_value() const noexcept {
+        V value = 0;
+        for(const std::uint32_t i : _best_sol) value += _values[i];
+        return value;
+    }
+
+    constexpr auto solution() const noexcept {
+        return std::ranges::views::transform(
+            _best_sol,
+            [this](const std::uint32_t i) { return _permuted_items[i]; });
     }
 };
 }  // namespace knapsack
@@ -0,0 +1,158 @@
+#ifndef FHAMONIC_KNAPSACK_KNAPSACK_BNB_BATCH_HPP
+#define FHAMONIC_KNAPSACK_KNAPSACK_BNB_BATCH_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "knapsack/knapsack_bnb.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+// Solves batches of independent 0-1 knapsack instances, given as (budget,
+// items) pairs, on a pool of threads started by the constructor, that wait
+// for the next batch between the calls to solve(). Each thread owns a
+// knapsack_bnb that is reset() with the instances it picks, so that once its
+// buffers have grown to the size of the largest instances, solving a batch
+// no longer allocates nor starts threads. The instances are distributed by
+// chunks of consecutive indices to balance the load. The calling thread
+// takes part in the solve, and solve() must not be called concurrently.
+template <typename C, typename RI, typename VM, typename CM>
+class knapsack_bnb_batch {
+public:
+    using I = std::ranges::range_value_t<RI>;
+    using V = std::invoke_result_t<VM, I>;
+    using instance = std::pair<C, RI>;
+    using solver = knapsack_bnb<C, RI, VM, CM>;
+
+    static constexpr std::size_t chunk_size = 16;
+
+private:
+    VM _value_map;
+    CM _cost_map;
+    // one per thread, the first one being the calling thread's
+    std::vector<solver> _workspaces;
+    // work of the current batch, given to the threads with its generation
+    std::mutex _mutex;
+    std::condition_variable_any _job_posted;
+    std::condition_variable _job_done;
+    std::size_t _generation;
+    std::size_t _nb_busy_threads;
+    void (*_job)(void *, solver &);
+    void * _job_context;
+    // declared last to be joined before the other members are destroyed
+    std::vector<std::jthread> _threads;
+
+private:
+    void worker_loop(const std::stop_token stoken, solver & s) noexcept {
+        std::size_t generation = 0;
+        for(;;) {
+            void (*job)(void *, solver &);
+            void * job_context;
+            {
+                std::unique_lock lock(_mutex);
+                if(!_job_posted.wait(lock, stoken, [&] {
+                       return _generation != generation;
+                   }))
+                    return;
+                generation = _generation;
+                job = _job;
+                job_context = _job_context;
+            }
+            job(job_context, s);
+            std::lock_guard lock(_mutex);
+            if(--_nb_busy_threads == 0) _job_done.notify_one();
+        }
+    }
+
+    // runs work(s) on each thread with its solver s and waits for them
+    template <typename W>
+    void run(W & work) {
+        {
+            std::lock_guard lock(_mutex);
+            _job = [](void * context, solver & s) {
+                (*static_cast<W *>(context))(s);
+            };
+            _job_context = &work;
+            _nb_busy_threads = _threads.size();
+            ++_generation;
+        }
+        _job_posted.notify_all();
+        work(_workspaces[0]);
+        std::unique_lock lock(_mutex);
+        _job_done.wait(lock, [this] { return _nb_busy_threads == 0; });
+    }
+
+public:
+    knapsack_bnb_batch(
+        const VM & value_map, const CM & cost_map,
+        const std::size_t nb_threads = std::thread::hardware_concurrency())
+        : _value_map(value_map)
+        , _cost_map(cost_map)
+        , _workspaces(std::max(nb_threads, std::size_t{1}))
+        , _generation(0)
+        , _nb_busy_threads(0)
+        , _job(nullptr)
+        , _job_context(nullptr) {
+        _threads.reserve(_workspaces.size() - 1);
+        for(std::size_t t = 1; t < _workspaces.size(); ++t)
+            _threads.emplace_back([this, t](const std::stop_token stoken) {
+                worker_loop(stoken, _workspaces[t]);
+            });
+    }
+
+    std::size_t nb_threads() const noexcept { return _workspaces.size(); }
+
+    // Calls on_solution(k, s) for each index k of instances, from the thread
+    // that solved it, s being the knapsack_bnb whose solution() and
+    // solution_value() are those of instances[k] during the call.
+    // on_solution must not throw.
+    template <typename F>
+    void solve(std::span<const instance> instances, F && on_solution) {
+        std::atomic<std::size_t> next_chunk = 0;
+        auto work = [&](solver & s) {
+            for(;;) {
+                const std::size_t begin =
+                    next_chunk.fetch_add(chunk_size, std::memory_order_relaxed);
+                if(begin >= instances.size()) return;
+                const std::size_t end =
+                    std::min(begin + chunk_size, instances.size());
+                for(std::size_t k = begin; k < end; ++k) {
+                    const auto & [budget, items] = instances[k];
+                    s.reset(budget, items, _value_map, _cost_map);
+                    s.solve();
+                    on_solution(k, std::as_const(s));
+                }
+            }
+        };
+        // a single chunk is not worth waking the threads
+        if(instances.size() <= chunk_size || _threads.empty()) {
+            work(_workspaces[0]);
+            return;
+        }
+        run(work);
+    }
+
+    // optimal values of the instances
+    std::vector<V> solve(std::span<const instance> instances) {
+        std::vector<V> values(instances.size());
+        solve(instances, [&values](const std::size_t k, const solver & s) {
+            values[k] = s.solution_value();
+        });
+        return values;
+    }
+};
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_KNAPSACK_BNB_BATCH_HPP
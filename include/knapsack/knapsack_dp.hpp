@@ -2,14 +2,26 @@
 #define FHAMONIC_KNAPSACK_DYNAMIC_PROGRAMMING_HPP
 
 #include <algorithm>
+#include <barrier>
 #include <concepts>
+#include <cstddef>
 #include <numeric>
+#include <ranges>
+#include <stop_token>
+#include <thread>
 #include <type_traits>
+#include <vector>
+
+#include "knapsack/allocator_vector.hpp"
+#include "knapsack/huge_pages.hpp"
+#include "knapsack/subset_sum_dp.hpp"
 
 namespace fhamonic {
 namespace knapsack {
 
-template <typename C, typename RI, typename VM, typename CM>
+// A is rebound for every internal container, the table included
+template <typename C, typename RI, typename VM, typename CM,
+          typename A = std::allocator<std::byte>>
     requires std::integral<C>
 class knapsack_dp {
 public:
@@ -17,19 +29,79 @@ public:
     using V = std::invoke_result_t<VM, I>;
 
     C _budget;
-    std::vector<I> _items;
-    std::vector<std::pair<V, C>> _value_cost_pairs;
-    std::vector<V> _tab;
+    detail::allocator_vector<I, A> _items;
+    detail::allocator_vector<std::pair<V, C>, A> _value_cost_pairs;
+    // allocated by the first solve and not initialized before, so that its
+    // pages are first touched, and placed on the NUMA node of, the threads
+    // that fill them
+    detail::uninitialized_vector<V, A> _tab;
+    // when every value equals its cost, the instance is a subset-sum and is
+    // solved by the word-parallel bitset kernel instead of filling _tab
+    bool _subset_sum;
+    detail::subset_sum_bitset<C, A> _subset_sum_bitset;
+
+private:
+    constexpr auto costs_view() const noexcept {
+        return std::ranges::views::transform(
+            _value_cost_pairs, [](const auto & p) { return p.second; });
+    }
+
+    // capacities [first, last) of the row of the item (value, cost)
+    static constexpr void fill_row(const V * const previous_tab,
+                                   V * const current_tab, const V value,
+                                   const C cost, const C first,
+                                   const C last) noexcept {
+        C w = std::clamp(cost, first, last);
+        std::copy(previous_tab + first, previous_tab + w, current_tab + first);
+        for(; w < last; ++w) {
+            current_tab[w] =
+                std::max(previous_tab[w], previous_tab[w - cost] + value);
+        }
+    }
+
+    constexpr void allocate_table() {
+        const std::size_t size = (_items.size() + 1) *
+                                 (static_cast<std::size_t>(_budget) + 1);
+        if(_tab.size() == size) return;
+        _tab.resize(size);
+        if(!std::is_constant_evaluated())
+            detail::advise_huge_pages(_tab.data(), _tab.size() * sizeof(V));
+    }
+
+    // the stop request is checked before each item row
+    template <typename S>
+    constexpr bool fill_table(S && stop_requested) {
+        if(_subset_sum) {
+            _subset_sum_bitset.solve(_budget, costs_view(), false);
+            return true;
+        }
+        allocate_table();
+        V * previous_tab = _tab.data();
+        std::fill(previous_tab, previous_tab + _budget + 1, V{0});
+
+        for(const auto & [value, cost] : _value_cost_pairs) {
+            if(stop_requested()) return false;
+            V * const current_tab = previous_tab + _budget + 1;
+            fill_row(previous_tab, current_tab, value, cost, 0, _budget + 1);
+            previous_tab = current_tab;
+        }
+        return true;
+    }
 
 public:
-    knapsack_dp(const C budget, const RI & items, const VM & value_map,
-                const CM & cost_map) noexcept
-        : _budget(budget) {
+    constexpr knapsack_dp(const C budget, const RI & items,
+                          const VM & value_map, const CM & cost_map,
+                          const A & allocator = A()) noexcept
+        : _budget(budget)
+        , _items(allocator)
+        , _value_cost_pairs(allocator)
+        , _tab(allocator)
+        , _subset_sum(false)
+        , _subset_sum_bitset(allocator) {
         if constexpr(std::ranges::sized_range<RI>) {
             const std::size_t nb_items = std::ranges::size(items);
             _items.reserve(nb_items);
             _value_cost_pairs.reserve(nb_items);
-            _tab.resize((nb_items + 1) * static_cast<std::size_t>(_budget + 1));
         }
 
         for(auto && i : items) {
@@ -40,41 +112,113 @@ public:
             _items.emplace_back(i);
             _value_cost_pairs.emplace_back(value, cost);
         }
+
+        if constexpr(std::integral<V> && std::equality_comparable_with<V, C>) {
+            _subset_sum = std::ranges::all_of(_value_cost_pairs, [](auto & p) {
+                return p.first == p.second;
+            });
+        }
     }
 
-    void solve() {
-        V * previous_tab = _tab.data();
-        for(C w = 0; w < _budget; ++w) {
-            previous_tab[w] = 0;
+    constexpr void solve() {
+        fill_table([] { return false; });
+    }
+
+    // returns false if stopped before the end, the solution is then invalid
+    bool solve(std::stop_token stoken) {
+        return fill_table([&stoken] { return stoken.stop_requested(); });
+    }
+
+    // Fills the table with nb_threads threads, each computing a contiguous
+    // range of at least a page of capacities in every row, and waiting for
+    // the others after each row. A thread is the first to write the pages of
+    // its ranges, that are thus placed on its NUMA node.
+    void solve_parallel(
+        std::size_t nb_threads = std::thread::hardware_concurrency()) {
+        const std::size_t nb_capacities = static_cast<std::size_t>(_budget) + 1;
+        constexpr std::size_t page_capacities =
+            std::max(std::size_t{4096} / sizeof(V), std::size_t{1});
+        nb_threads = std::clamp(
+            nb_threads, std::size_t{1},
+            std::max(nb_capacities / page_capacities, std::size_t{1}));
+        if(_subset_sum || nb_threads == 1) {
+            solve();
+            return;
         }
+        allocate_table();
 
-        for(const auto & [value, cost] : _value_cost_pairs) {
-            V * const current_tab = previous_tab + _budget + 1;
-            C w = std::min(_budget, cost);
-            std::copy(previous_tab, previous_tab + w, current_tab);
-            for(; w <= _budget; ++w) {
-                current_tab[w] =
-                    std::max(previous_tab[w], previous_tab[w - cost] + value);
+        detail::allocator_vector<C, A> bounds(nb_threads + 1,
+                                              _items.get_allocator());
+        for(std::size_t t = 0; t < nb_threads; ++t)
+            bounds[t] = static_cast<C>(nb_capacities * t / nb_threads /
+                                       page_capacities * page_capacities);
+        bounds[nb_threads] = static_cast<C>(nb_capacities);
+
+        std::barrier row_barrier(static_cast<std::ptrdiff_t>(nb_threads));
+        auto fill_range = [&](const std::size_t t) {
+            const C first = bounds[t];
+            const C last = bounds[t + 1];
+            V * previous_tab = _tab.data();
+            std::fill(previous_tab + first, previous_tab + last, V{0});
+            for(const auto & [value, cost] : _value_cost_pairs) {
+                row_barrier.arrive_and_wait();
+                V * const current_tab = previous_tab + nb_capacities;
+                fill_row(previous_tab, current_tab, value, cost, first, last);
+                previous_tab = current_tab;
             }
-            previous_tab = current_tab;
+        };
+        std::vector<std::jthread> threads;
+        threads.reserve(nb_threads - 1);
+        for(std::size_t t = 1; t < nb_threads; ++t)
+            threads.emplace_back(fill_range, t);
+        fill_range(0);
+    }
+
+    // optimal value for every budget from 0 to the constructor one, once solved
+    constexpr std::vector<V> value_profile() const noexcept {
+        const std::size_t nb_capacities = static_cast<std::size_t>(_budget) + 1;
+        std::vector<V> profile(nb_capacities);
+        if(_subset_sum) {
+            V best_cost = 0;
+            for(C w = 0; w <= _budget; ++w) {
+                if(_subset_sum_bitset.reachable(w))
+                    best_cost = static_cast<V>(w);
+                profile[static_cast<std::size_t>(w)] = best_cost;
+            }
+            return profile;
         }
+        const V * const last_tab = _tab.data() + _items.size() * nb_capacities;
+        std::copy(last_tab, last_tab + nb_capacities, profile.begin());
+        return profile;
     }
 
-    auto solution() const noexcept {
+    // optimal solution for the given budget, lowered to the constructor one if
+    // above, once solved
+    constexpr auto solution(C budget) const noexcept {
+        budget = std::min(budget, _budget);
         const std::size_t nb_items = _items.size();
+        const std::size_t nb_capacities = static_cast<std::size_t>(_budget) + 1;
         std::vector<I> solution;
-        const V * step = _tab.data() + (nb_items * (_budget + 1)) + _budget;
-
-        for(std::size_t i = (nb_items - 1); i > 0; --i) {
-            const bool taken = (*step > *(step - _budget - 1));
+        if(_subset_sum) {
+            C best_cost = budget;
+            while(!_subset_sum_bitset.reachable(best_cost)) --best_cost;
+            _subset_sum_bitset.for_each_taken(
+                costs_view(), best_cost,
+                [&](std::size_t i) { solution.push_back(_items[i]); });
+            return solution;
+        }
+        const V * step = _tab.data() + nb_items * nb_capacities +
+                         static_cast<std::size_t>(budget);
+        for(std::size_t i = nb_items; i-- > 0;) {
+            const bool taken = (*step > *(step - nb_capacities));
             if(taken) solution.push_back(_items[i]);
-            step -= _budget + 1 + taken * _value_cost_pairs[i].second;
+            step -= nb_capacities + taken * static_cast<std::size_t>(
+                                            _value_cost_pairs[i].second);
         }
-        const bool taken = (*step > *(step - _budget - 1));
-        if(taken) solution.push_back(_items[0]);
-
         return solution;
     }
+
+    constexpr auto solution() const noexcept { return solution(_budget); }
 };
 
 }  // namespace knapsack
@@ -0,0 +1,322 @@
+#ifndef FHAMONIC_KNAPSACK_KNAPSACK_SOLVER_HPP
+#define FHAMONIC_KNAPSACK_KNAPSACK_SOLVER_HPP
+
+#include <atomic>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <numeric>
+#include <optional>
+#include <ostream>
+#include <ranges>
+#include <sstream>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#include "knapsack/knapsack_bnb.hpp"
+#include "knapsack/knapsack_dp.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+enum class knapsack_engine { automatic, bnb, dp, race };
+
+inline std::string_view engine_name(const knapsack_engine engine) noexcept {
+    switch(engine) {
+        case knapsack_engine::bnb:
+            return "knapsack_bnb";
+        case knapsack_engine::dp:
+            return "knapsack_dp";
+        case knapsack_engine::race:
+            return "race of knapsack_bnb and knapsack_dp";
+        default:
+            return "automatic";
+    }
+}
+
+struct knapsack_solver_options {
+    // overrides the automatic choice, race runs knapsack_bnb and knapsack_dp
+    // on two threads and stops the slowest when the other finishes
+    knapsack_engine engine = knapsack_engine::automatic;
+    // memory allowed for the dynamic programming table, 0 for half of the
+    // available memory
+    std::size_t max_dp_memory = 0;
+    // receives the decision if not null
+    std::ostream * log = nullptr;
+};
+
+namespace detail {
+
+inline std::size_t available_memory() noexcept {
+#if defined(_SC_AVPHYS_PAGES) && defined(_SC_PAGESIZE)
+    const long nb_pages = ::sysconf(_SC_AVPHYS_PAGES);
+    const long page_size = ::sysconf(_SC_PAGESIZE);
+    if(nb_pages > 0 && page_size > 0)
+        return static_cast<std::size_t>(nb_pages) *
+               static_cast<std::size_t>(page_size);
+#endif
+    return std::size_t{1} << 32;
+}
+
+// knapsack_dp requires integral costs
+template <typename C, typename RI, typename VM, typename CM>
+struct dp_engine {
+    using type = std::monostate;
+};
+template <std::integral C, typename RI, typename VM, typename CM>
+struct dp_engine<C, RI, VM, CM> {
+    using type = knapsack_dp<C, RI, VM, CM>;
+};
+
+}  // namespace detail
+
+// Facade that dispatches to the engine predicted fastest from cheap instance
+// features, computed in one pass over the items :
+//  - knapsack_dp needs integral costs and a table that fits in memory, its
+//    budget being divided by the gcd of the costs ;
+//  - it is then preferred on strongly correlated instances (including
+//    subset-sum ones), where the LP bound of knapsack_bnb is weak, and on
+//    small tables ;
+//  - knapsack_bnb otherwise.
+template <typename C, typename RI, typename VM, typename CM>
+    requires std::ranges::forward_range<RI>
+class knapsack_solver {
+public:
+    using I = std::ranges::range_value_t<RI>;
+    using V = std::invoke_result_t<VM, I>;
+
+    struct features {
+        std::size_t nb_items = 0;  // of value > 0 and cost <= budget
+        C budget = 0;
+        double value_cost_correlation = 0.0;
+        C cost_gcd = 1;
+        bool subset_sum = false;
+        std::size_t dp_table_bytes = 0;  // 0 if knapsack_dp cannot be used
+    };
+
+    // correlation above which knapsack_dp is preferred
+    static constexpr double correlation_threshold = 0.9;
+    // number of cells under which knapsack_dp is always preferred
+    static constexpr std::size_t small_dp_table_cells = std::size_t{1} << 20;
+
+private:
+    struct scaled_cost_map {
+        CM cost_map;
+        C gcd;
+        C operator()(const I & i) const { return cost_map(i) / gcd; }
+    };
+    using bnb_engine = knapsack_bnb<C, RI, VM, CM>;
+    using dp_engine =
+        typename detail::dp_engine<C, RI, VM, scaled_cost_map>::type;
+
+    features _features;
+    knapsack_engine _engine;
+    std::string _decision;
+    std::optional<bnb_engine> _bnb;
+    std::optional<dp_engine> _dp;
+    knapsack_engine _solved_by;
+
+private:
+    static features compute_features(const C budget, const RI & items,
+                                     const VM & value_map,
+                                     const CM & cost_map) noexcept {
+        features f;
+        f.budget = budget;
+        double sum_v = 0, sum_c = 0, sum_vv = 0, sum_cc = 0, sum_vc = 0;
+        C gcd = 0;
+        f.subset_sum = true;
+        for(auto && i : items) {
+            const V value = value_map(i);
+            if(value == static_cast<V>(0)) continue;
+            const C cost = cost_map(i);
+            // the items above the budget must remain above it once scaled,
+            // so the gcd divides their costs too
+            if constexpr(std::integral<C>) gcd = std::gcd(gcd, cost);
+            if(cost > budget) continue;
+            ++f.nb_items;
+            const double v = static_cast<double>(value);
+            const double c = static_cast<double>(cost);
+            sum_v += v;
+            sum_c += c;
+            sum_vv += v * v;
+            sum_cc += c * c;
+            sum_vc += v * c;
+            if constexpr(std::integral<V> &&
+                         std::equality_comparable_with<V, C>) {
+                f.subset_sum = f.subset_sum && (value == cost);
+            } else {
+                f.subset_sum = false;
+            }
+        }
+        f.subset_sum = f.subset_sum && f.nb_items > 0;
+        if(f.nb_items > 0) {
+            const double n = static_cast<double>(f.nb_items);
+            const double cov = sum_vc / n - (sum_v / n) * (sum_c / n);
+            const double var_v = sum_vv / n - (sum_v / n) * (sum_v / n);
+            const double var_c = sum_cc / n - (sum_c / n) * (sum_c / n);
+            f.value_cost_correlation = (var_v > 0 && var_c > 0)
+                                           ? cov / std::sqrt(var_v * var_c)
+                                           : 1.0;
+        }
+
+        if constexpr(std::integral<C>) {
+            // the subset-sum kernel of knapsack_dp needs unscaled costs
+            f.cost_gcd = (f.subset_sum || gcd == 0) ? 1 : gcd;
+            const std::size_t nb_capacities =
+                static_cast<std::size_t>(budget / f.cost_gcd) + 1;
+            f.dp_table_bytes =
+                f.subset_sum
+                    ? nb_capacities / 4 + nb_capacities * sizeof(std::uint32_t)
+                    : (f.nb_items + 1) * nb_capacities * sizeof(V);
+        }
+        return f;
+    }
+
+    knapsack_engine choose_engine(const knapsack_solver_options & options,
+                                  std::ostringstream & reason) const noexcept {
+        const std::size_t max_dp_memory =
+            options.max_dp_memory ? options.max_dp_memory
+                                  : detail::available_memory() / 2;
+        if(options.engine != knapsack_engine::automatic) {
+            reason << "requested";
+            if(options.engine == knapsack_engine::bnb) return options.engine;
+            if(_features.dp_table_bytes == 0) {
+                reason << ", but knapsack_dp needs integral costs";
+                return knapsack_engine::bnb;
+            }
+            if(_features.dp_table_bytes > max_dp_memory) {
+                reason << ", but dp table of " << _features.dp_table_bytes
+                       << " bytes exceeds " << max_dp_memory << " bytes";
+                return knapsack_engine::bnb;
+            }
+            return options.engine;
+        }
+        if(_features.dp_table_bytes == 0) {
+            reason << "knapsack_dp needs integral costs";
+            return knapsack_engine::bnb;
+        }
+        if(_features.dp_table_bytes > max_dp_memory) {
+            reason << "dp table of " << _features.dp_table_bytes
+                   << " bytes exceeds " << max_dp_memory << " bytes";
+            return knapsack_engine::bnb;
+        }
+        if(_features.subset_sum) {
+            reason << "subset-sum instance";
+            return knapsack_engine::dp;
+        }
+        if(_features.value_cost_correlation > correlation_threshold) {
+            reason << "correlation " << _features.value_cost_correlation
+                   << " > " << correlation_threshold;
+            return knapsack_engine::dp;
+        }
+        const std::size_t nb_cells = _features.dp_table_bytes / sizeof(V);
+        if(nb_cells < small_dp_table_cells) {
+            reason << "small dp table of " << nb_cells << " cells";
+            return knapsack_engine::dp;
+        }
+        reason << "correlation " << _features.value_cost_correlation
+               << " <= " << correlation_threshold;
+        return knapsack_engine::bnb;
+    }
+
+    // The first engine to finish wakes this thread that stops both. An
+    // engine that fails to allocate its memory drops out of the race, that
+    // knapsack_bnb then wins.
+    void race() {
+        std::atomic<bool> finished = false;
+        auto run = [this, &finished](auto & engine, knapsack_engine id) {
+            return [this, &finished, &engine, id](std::stop_token stoken) {
+                try {
+                    if(!engine.solve(stoken)) return;
+                } catch(const std::bad_alloc &) {
+                    return;
+                }
+                if(!finished.exchange(true)) {
+                    _solved_by = id;
+                    finished.notify_one();
+                }
+            };
+        };
+        std::jthread bnb_thread(run(*_bnb, knapsack_engine::bnb));
+        std::jthread dp_thread(run(*_dp, knapsack_engine::dp));
+        finished.wait(false);
+        bnb_thread.request_stop();
+        dp_thread.request_stop();
+    }
+
+public:
+    knapsack_solver(const C budget, const RI & items, const VM & value_map,
+                    const CM & cost_map,
+                    const knapsack_solver_options & options = {}) noexcept
+        : _features(compute_features(budget, items, value_map, cost_map))
+        , _solved_by(knapsack_engine::automatic) {
+        std::ostringstream reason;
+        _engine = choose_engine(options, reason);
+
+        std::ostringstream decision;
+        decision << engine_name(_engine) << " (" << reason.str()
+                 << ") for n=" << _features.nb_items
+                 << " budget=" << _features.budget
+                 << " correlation=" << _features.value_cost_correlation
+                 << " gcd=" << _features.cost_gcd
+                 << " dp_table_bytes=" << _features.dp_table_bytes;
+        _decision = decision.str();
+        if(options.log) *options.log << _decision << std::endl;
+
+        if(_engine != knapsack_engine::dp)
+            _bnb.emplace(budget, items, value_map, cost_map);
+        if constexpr(std::integral<C>) {
+            if(_engine != knapsack_engine::bnb)
+                _dp.emplace(budget / _features.cost_gcd, items, value_map,
+                            scaled_cost_map{cost_map, _features.cost_gcd});
+        }
+    }
+
+    void solve() {
+        if(_engine == knapsack_engine::bnb) {
+            _bnb->solve();
+            _solved_by = knapsack_engine::bnb;
+            return;
+        }
+        if constexpr(std::integral<C>) {
+            if(_engine == knapsack_engine::dp) {
+                _dp->solve();
+                _solved_by = knapsack_engine::dp;
+                return;
+            }
+            race();
+        }
+    }
+
+    const features & instance_features() const noexcept { return _features; }
+    knapsack_engine engine() const noexcept { return _engine; }
+    // the engine whose solution is returned, the winner of a race
+    knapsack_engine solved_by() const noexcept { return _solved_by; }
+    const std::string & decision() const noexcept { return _decision; }
+
+    std::vector<I> solution() const {
+        std::vector<I> solution;
+        if(_solved_by == knapsack_engine::bnb) {
+            for(auto && i : _bnb->solution()) solution.emplace_back(i);
+        } else if constexpr(std::integral<C>) {
+            if(_solved_by == knapsack_engine::dp) solution = _dp->solution();
+        }
+        return solution;
+    }
+};
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_KNAPSACK_SOLVER_HPP
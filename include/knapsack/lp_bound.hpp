@@ -0,0 +1,46 @@
+#ifndef FHAMONIC_KNAPSACK_LP_BOUND_HPP
+#define FHAMONIC_KNAPSACK_LP_BOUND_HPP
+
+#include <algorithm>
+#include <cstddef>
+
+#include "knapsack/integer_ratio.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+namespace detail {
+
+// LP bound of the items from i to nb_items - 1, sorted by decreasing
+// value/cost ratio : they are taken while they fit in the budget left and
+// the first one that does not is taken fractionally. The fractional value
+// is floored exactly for integral values and costs, through doubles
+// otherwise, the bound being raised by tolerance times its value, at least 1,
+// to absorb the rounding errors of real costs.
+template <typename V, typename C>
+constexpr V lp_bound(const V * values, const C * costs, std::size_t i,
+                     const std::size_t nb_items, V bound_value,
+                     C bound_budget_left,
+                     const double tolerance = 0.0) noexcept {
+    for(; i < nb_items; ++i) {
+        if(bound_budget_left < costs[i]) {
+            if constexpr(exact_ratios<V, C>) {
+                return bound_value + fractional_value(bound_budget_left,
+                                                      values[i], costs[i]);
+            } else {
+                double bound = bound_value + bound_budget_left * values[i] /
+                                                 static_cast<double>(costs[i]);
+                if(tolerance > 0.0) bound += tolerance * std::max(1.0, bound);
+                return static_cast<V>(bound);
+            }
+        }
+        bound_budget_left -= costs[i];
+        bound_value += values[i];
+    }
+    return bound_value;
+}
+
+}  // namespace detail
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_LP_BOUND_HPP
@@ -0,0 +1,301 @@
+#ifndef FHAMONIC_KNAPSACK_MULTIDIMENSIONAL_KNAPSACK_BNB_HPP
+#define FHAMONIC_KNAPSACK_MULTIDIMENSIONAL_KNAPSACK_BNB_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "knapsack/lp_bound.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+// 0-1 knapsack with one budget per dimension (weight, volume, ...).
+// Bounds come from the surrogate relaxation : the constraints are aggregated
+// with multipliers u_d into a single one of costs sum_d u_d * c_d(i) and
+// budget sum_d u_d * B_d whose LP bound is computed as in knapsack_bnb. The
+// multipliers are tuned at the root by a few subgradient steps minimizing
+// this bound. Costs are stored dimension by dimension (one contiguous column
+// per dimension) so that the search can test 64 items at once against the
+// budgets left.
+template <typename RB, typename RI, typename VM, typename RCM>
+class multidimensional_knapsack_bnb {
+private:
+    using C = std::ranges::range_value_t<RB>;
+    using I = std::ranges::range_value_t<RI>;
+    using V = std::invoke_result_t<VM, I>;
+
+    static constexpr std::size_t block_size = 64;
+    static constexpr std::size_t nb_multipliers_iterations = 32;
+    // absorbs the rounding errors of the surrogate costs in the bounds,
+    // relatively to their values
+    static constexpr double bound_tolerance = 1e-6;
+
+    std::size_t _nb_dimensions;
+    std::vector<C> _budgets;
+    std::vector<I> _permuted_items;
+    std::vector<V> _values;
+    std::vector<double> _surrogate_costs;
+    std::vector<C> _costs;  // _costs[d * _nb_items + i]
+    std::size_t _nb_items;
+    std::vector<double> _multipliers;
+    std::vector<std::size_t> _best_sol;
+
+private:
+    const C * costs_column(const std::size_t d) const noexcept {
+        return _costs.data() + d * _nb_items;
+    }
+
+    double value_cost_ratio(const V value, const double cost) const noexcept {
+        if constexpr(std::numeric_limits<double>::is_iec559) {
+            return value / cost;
+        } else {
+            return (cost == 0) ? std::numeric_limits<double>::max()
+                               : (value / cost);
+        }
+    }
+
+    V computeUpperBound(const std::size_t i, const V bound_value,
+                        const double bound_budget_left) const noexcept {
+        return detail::lp_bound(_values.data(), _surrogate_costs.data(), i,
+                                _nb_items, bound_value, bound_budget_left,
+                                bound_tolerance);
+    }
+
+    double surrogate_budget(const C * budgets_left) const noexcept {
+        double budget = 0;
+        for(std::size_t d = 0; d < _nb_dimensions; ++d)
+            budget += _multipliers[d] * static_cast<double>(budgets_left[d]);
+        return budget;
+    }
+
+    void compute_surrogate_costs(const std::vector<double> & multipliers,
+                                 std::vector<double> & surrogate_costs) const {
+        surrogate_costs.assign(_nb_items, 0.0);
+        for(std::size_t d = 0; d < _nb_dimensions; ++d) {
+            const C * const column = costs_column(d);
+            for(std::size_t i = 0; i < _nb_items; ++i)
+                surrogate_costs[i] +=
+                    multipliers[d] * static_cast<double>(column[i]);
+        }
+    }
+
+    // sorts the items by decreasing value / surrogate cost ratio
+    void sort_items(const std::vector<double> & surrogate_costs) {
+        std::vector<std::size_t> permutation(_nb_items);
+        std::iota(permutation.begin(), permutation.end(), std::size_t{0});
+        std::ranges::sort(permutation, [&](std::size_t i, std::size_t j) {
+            return value_cost_ratio(_values[i], surrogate_costs[i]) >
+                   value_cost_ratio(_values[j], surrogate_costs[j]);
+        });
+        auto permute = [&permutation](auto & v) {
+            std::remove_cvref_t<decltype(v)> permuted;
+            permuted.reserve(v.size());
+            for(std::size_t i : permutation) permuted.push_back(v[i]);
+            v = std::move(permuted);
+        };
+        permute(_permuted_items);
+        permute(_values);
+        _surrogate_costs = surrogate_costs;
+        permute(_surrogate_costs);
+        std::vector<C> costs(_costs.size());
+        for(std::size_t d = 0; d < _nb_dimensions; ++d) {
+            const C * const column = costs_column(d);
+            for(std::size_t i = 0; i < _nb_items; ++i)
+                costs[d * _nb_items + i] = column[permutation[i]];
+        }
+        _costs = std::move(costs);
+    }
+
+    // projected subgradient descent on the surrogate LP bound, the
+    // multipliers being expressed relatively to the budgets : u_d = w_d / B_d
+    // with w in the unit simplex
+    void compute_multipliers() {
+        std::vector<double> weights(_nb_dimensions,
+                                    1.0 / static_cast<double>(_nb_dimensions));
+        auto to_multipliers = [this](const std::vector<double> & w) {
+            std::vector<double> multipliers(_nb_dimensions);
+            for(std::size_t d = 0; d < _nb_dimensions; ++d)
+                multipliers[d] =
+                    w[d] / std::max(1.0, static_cast<double>(_budgets[d]));
+            return multipliers;
+        };
+        _multipliers = to_multipliers(weights);
+
+        std::vector<double> surrogate_costs;
+        std::vector<std::size_t> order(_nb_items);
+        std::vector<double> usages(_nb_dimensions);
+        double best_bound = std::numeric_limits<double>::max();
+        for(std::size_t iteration = 0; iteration < nb_multipliers_iterations;
+            ++iteration) {
+            const std::vector<double> multipliers = to_multipliers(weights);
+            compute_surrogate_costs(multipliers, surrogate_costs);
+            std::iota(order.begin(), order.end(), std::size_t{0});
+            std::ranges::sort(order, [&](std::size_t i, std::size_t j) {
+                return _values[i] * surrogate_costs[j] >
+                       _values[j] * surrogate_costs[i];
+            });
+            double budget_left = 0;
+            for(std::size_t d = 0; d < _nb_dimensions; ++d)
+                budget_left +=
+                    multipliers[d] * static_cast<double>(_budgets[d]);
+            double bound = 0;
+            std::ranges::fill(usages, 0.0);
+            for(std::size_t i : order) {
+                const double fraction =
+                    (surrogate_costs[i] <= budget_left)
+                        ? 1.0
+                        : budget_left / surrogate_costs[i];
+                bound += fraction * static_cast<double>(_values[i]);
+                budget_left -= fraction * surrogate_costs[i];
+                for(std::size_t d = 0; d < _nb_dimensions; ++d)
+                    usages[d] += fraction *
+                                 static_cast<double>(costs_column(d)[i]);
+                if(fraction < 1.0) break;
+            }
+            if(bound < best_bound) {
+                best_bound = bound;
+                _multipliers = multipliers;
+            }
+            const double step = 1.0 / static_cast<double>(iteration + 1);
+            double norm = 0;
+            for(std::size_t d = 0; d < _nb_dimensions; ++d) {
+                const double budget =
+                    std::max(1.0, static_cast<double>(_budgets[d]));
+                weights[d] = std::max(
+                    0.0, weights[d] + step * (usages[d] / budget - 1.0));
+                norm += weights[d];
+            }
+            if(norm == 0.0) break;  // no dimension is binding
+            for(double & w : weights) w /= norm;
+        }
+        compute_surrogate_costs(_multipliers, surrogate_costs);
+        sort_items(surrogate_costs);
+    }
+
+    // index of the first item j >= i that fits in every budget left
+    std::size_t next_fitting_item(std::size_t i,
+                                  const C * budgets_left) const noexcept {
+        for(; i < _nb_items; i += block_size) {
+            const std::size_t block_end = std::min(i + block_size, _nb_items);
+            std::uint64_t exceed_mask = 0;
+            for(std::size_t d = 0; d < _nb_dimensions; ++d) {
+                const C * const column = costs_column(d);
+                const C budget_left = budgets_left[d];
+                for(std::size_t j = i; j < block_end; ++j)
+                    exceed_mask |= static_cast<std::uint64_t>(
+                                       column[j] > budget_left)
+                                   << (j - i);
+            }
+            const std::uint64_t fit_mask = ~exceed_mask;
+            const std::size_t offset =
+                static_cast<std::size_t>(std::countr_zero(fit_mask));
+            if(i + offset < block_end) return i + offset;
+        }
+        return _nb_items;
+    }
+
+    void take(const std::size_t i, C * budgets_left) const noexcept {
+        for(std::size_t d = 0; d < _nb_dimensions; ++d)
+            budgets_left[d] -= costs_column(d)[i];
+    }
+    void untake(const std::size_t i, C * budgets_left) const noexcept {
+        for(std::size_t d = 0; d < _nb_dimensions; ++d)
+            budgets_left[d] += costs_column(d)[i];
+    }
+
+    void iterative_bnb() noexcept {
+        _best_sol.resize(0);
+        std::size_t i = next_fitting_item(0, _budgets.data());
+        if(i == _nb_items) return;
+        std::vector<std::size_t> current_sol;
+        std::vector<C> budgets_left = _budgets;
+        V current_sol_value = 0;
+        V best_sol_value = 0;
+        goto begin;
+    backtrack:
+        while(!current_sol.empty()) {
+            i = current_sol.back();
+            current_sol_value -= _values[i];
+            untake(i, budgets_left.data());
+            current_sol.pop_back();
+            for(i = next_fitting_item(i + 1, budgets_left.data());
+                i < _nb_items;
+                i = next_fitting_item(i + 1, budgets_left.data())) {
+                if(computeUpperBound(i, current_sol_value,
+                                     surrogate_budget(budgets_left.data())) <=
+                   best_sol_value)
+                    goto backtrack;
+            begin:
+                current_sol_value += _values[i];
+                take(i, budgets_left.data());
+                current_sol.push_back(i);
+            }
+            if(current_sol_value <= best_sol_value) continue;
+            best_sol_value = current_sol_value;
+            _best_sol = current_sol;
+        }
+    }
+
+public:
+    // cost_maps holds one cost map per budget, in the same order
+    multidimensional_knapsack_bnb(const RB & budgets, const RI & items,
+                                  const VM & value_map,
+                                  const RCM & cost_maps) noexcept
+        : _nb_dimensions(0)
+        , _nb_items(0) {
+        _budgets.assign(std::ranges::begin(budgets), std::ranges::end(budgets));
+        _nb_dimensions = _budgets.size();
+
+        if constexpr(std::ranges::sized_range<RCM>)
+            assert(std::ranges::size(cost_maps) == _nb_dimensions);
+
+        std::vector<std::vector<C>> costs_columns(_nb_dimensions);
+        std::vector<C> item_costs(_nb_dimensions);
+        for(auto && i : items) {
+            const V value = value_map(i);
+            if(value == static_cast<V>(0)) continue;
+            std::size_t d = 0;
+            for(auto && cost_map : cost_maps) {
+                if(d == _nb_dimensions) break;
+                item_costs[d] = cost_map(i);
+                if(item_costs[d] > _budgets[d]) break;
+                ++d;
+            }
+            if(d < _nb_dimensions) continue;
+            _permuted_items.emplace_back(i);
+            _values.push_back(value);
+            for(d = 0; d < _nb_dimensions; ++d)
+                costs_columns[d].push_back(item_costs[d]);
+        }
+        _nb_items = _permuted_items.size();
+        _costs.reserve(_nb_dimensions * _nb_items);
+        for(auto && column : costs_columns)
+            _costs.insert(_costs.end(), column.begin(), column.end());
+
+        compute_multipliers();
+    }
+
+    void solve() noexcept { iterative_bnb(); }
+
+    const std::vector<double> & surrogate_multipliers() const noexcept {
+        return _multipliers;
+    }
+
+    auto solution() const noexcept {
+        return std::ranges::views::transform(
+            _best_sol, [this](std::size_t i) { return _permuted_items[i]; });
+    }
+};
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_MULTIDIMENSIONAL_KNAPSACK_BNB_HPP
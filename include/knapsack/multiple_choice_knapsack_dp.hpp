@@ -0,0 +1,241 @@
+#ifndef FHAMONIC_KNAPSACK_MULTIPLE_CHOICE_KNAPSACK_DP_HPP
+#define FHAMONIC_KNAPSACK_MULTIPLE_CHOICE_KNAPSACK_DP_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fhamonic {
+namespace knapsack {
+
+// Multiple-choice knapsack : exactly one item must be chosen in each group.
+// In each group, the items are sorted by cost and the dominated ones (costing
+// more for no more value) are removed. The LP relaxation is solved greedily
+// on the upper convex hulls of the groups (LP-dominated items removed) by
+// taking the hull increments in decreasing value/cost slope, it gives an
+// upper bound and an integral solution. When they do not match, the exact
+// solution is computed by dynamic programming over the budgets on the
+// dominance-free groups (LP-dominated items can still be optimal).
+template <typename C, typename RG, typename VM, typename CM>
+    requires std::integral<C>
+class multiple_choice_knapsack_dp {
+public:
+    using I = std::ranges::range_value_t<std::ranges::range_value_t<RG>>;
+    using V = std::invoke_result_t<VM, I>;
+
+private:
+    // absorbs the rounding errors of the LP bound
+    static constexpr double bound_tolerance = 1e-6;
+
+    C _budget;
+    bool _feasible;
+    std::vector<std::size_t> _groups_offsets;
+    std::vector<I> _items;
+    std::vector<std::pair<V, C>> _value_cost_pairs;
+
+    double _lp_bound;
+    std::vector<std::size_t> _best_sol;  // chosen index in each group
+
+private:
+    std::size_t nb_groups() const noexcept {
+        return _groups_offsets.size() - 1;
+    }
+
+    // greedy LP on the convex hulls, returns the integral part of the LP
+    // solution
+    std::vector<std::size_t> solve_lp_relaxation() {
+        struct increment {
+            std::size_t group, to;
+            V value;
+            C cost;
+        };
+        std::vector<increment> increments;
+        std::vector<std::size_t> hull;
+        V value = 0;
+        C budget_left = _budget;
+        std::vector<std::size_t> lp_sol(nb_groups());
+        for(std::size_t g = 0; g < nb_groups(); ++g) {
+            const std::size_t first = _groups_offsets[g];
+            const std::size_t last = _groups_offsets[g + 1];
+            hull.clear();
+            for(std::size_t i = first; i < last; ++i) {
+                const auto & [v, c] = _value_cost_pairs[i];
+                while(hull.size() >= 2) {
+                    const auto & [v1, c1] = _value_cost_pairs[hull.back()];
+                    const auto & [v0, c0] =
+                        _value_cost_pairs[hull[hull.size() - 2]];
+                    // pop if (v1 - v0)/(c1 - c0) <= (v - v1)/(c - c1)
+                    if(static_cast<double>(v1 - v0) *
+                           static_cast<double>(c - c1) >
+                       static_cast<double>(v - v1) *
+                           static_cast<double>(c1 - c0))
+                        break;
+                    hull.pop_back();
+                }
+                hull.push_back(i);
+            }
+            lp_sol[g] = 0;
+            value += _value_cost_pairs[first].first;
+            budget_left -= _value_cost_pairs[first].second;
+            for(std::size_t k = 1; k < hull.size(); ++k)
+                increments.push_back(
+                    {g, hull[k] - first,
+                     _value_cost_pairs[hull[k]].first -
+                         _value_cost_pairs[hull[k - 1]].first,
+                     _value_cost_pairs[hull[k]].second -
+                         _value_cost_pairs[hull[k - 1]].second});
+        }
+        // increments of a group have decreasing slopes so a stable sort
+        // preserves their order
+        std::ranges::stable_sort(
+            increments, [](const increment & a, const increment & b) {
+                return static_cast<double>(a.value) *
+                           static_cast<double>(b.cost) >
+                       static_cast<double>(b.value) *
+                           static_cast<double>(a.cost);
+            });
+        _lp_bound = static_cast<double>(value);
+        for(const increment & inc : increments) {
+            if(budget_left < inc.cost) {
+                _lp_bound += static_cast<double>(budget_left) *
+                             static_cast<double>(inc.value) /
+                             static_cast<double>(inc.cost);
+                break;
+            }
+            budget_left -= inc.cost;
+            value += inc.value;
+            _lp_bound += static_cast<double>(inc.value);
+            lp_sol[inc.group] = inc.to;
+        }
+        return lp_sol;
+    }
+
+    V solution_value(const std::vector<std::size_t> & sol) const noexcept {
+        V value = 0;
+        for(std::size_t g = 0; g < nb_groups(); ++g)
+            value += _value_cost_pairs[_groups_offsets[g] + sol[g]].first;
+        return value;
+    }
+
+    void solve_dp() {
+        const std::size_t nb_capacities =
+            static_cast<std::size_t>(_budget) + 1;
+        constexpr V unreachable = std::numeric_limits<V>::lowest();
+        std::vector<V> previous_tab(nb_capacities, 0);
+        std::vector<V> current_tab(nb_capacities);
+        std::vector<std::uint32_t> choices(nb_groups() * nb_capacities);
+
+        for(std::size_t g = 0; g < nb_groups(); ++g) {
+            std::fill(current_tab.begin(), current_tab.end(), unreachable);
+            std::uint32_t * const group_choices =
+                choices.data() + g * nb_capacities;
+            const std::size_t first = _groups_offsets[g];
+            for(std::size_t i = first; i < _groups_offsets[g + 1]; ++i) {
+                const auto & [value, cost] = _value_cost_pairs[i];
+                const std::uint32_t choice =
+                    static_cast<std::uint32_t>(i - first);
+                for(std::size_t w = static_cast<std::size_t>(cost);
+                    w < nb_capacities; ++w) {
+                    const V prev =
+                        previous_tab[w - static_cast<std::size_t>(cost)];
+                    if(prev == unreachable) continue;
+                    if(prev + value > current_tab[w]) {
+                        current_tab[w] = prev + value;
+                        group_choices[w] = choice;
+                    }
+                }
+            }
+            previous_tab.swap(current_tab);
+        }
+
+        std::size_t w = static_cast<std::size_t>(
+            std::ranges::max_element(previous_tab) - previous_tab.begin());
+        for(std::size_t g = nb_groups(); g-- > 0;) {
+            const std::size_t choice = choices[g * nb_capacities + w];
+            _best_sol[g] = choice;
+            w -= static_cast<std::size_t>(
+                _value_cost_pairs[_groups_offsets[g] + choice].second);
+        }
+    }
+
+public:
+    multiple_choice_knapsack_dp(const C budget, const RG & groups,
+                                const VM & value_map,
+                                const CM & cost_map) noexcept
+        : _budget(budget)
+        , _feasible(true)
+        , _groups_offsets{0}
+        , _lp_bound(0) {
+        C min_costs_sum = 0;
+        std::vector<I> group_items;
+        std::vector<std::pair<V, C>> group_pairs;
+        std::vector<std::size_t> permutation;
+        for(auto && group : groups) {
+            group_items.clear();
+            group_pairs.clear();
+            for(auto && i : group) {
+                const C cost = cost_map(i);
+                if(cost > _budget) continue;
+                group_items.emplace_back(i);
+                group_pairs.emplace_back(value_map(i), cost);
+            }
+            permutation.resize(group_items.size());
+            std::iota(permutation.begin(), permutation.end(), std::size_t{0});
+            std::ranges::sort(permutation, [&](std::size_t i, std::size_t j) {
+                return group_pairs[i].second < group_pairs[j].second ||
+                       (group_pairs[i].second == group_pairs[j].second &&
+                        group_pairs[i].first > group_pairs[j].first);
+            });
+            // keep only the items that are not dominated
+            const std::size_t first = _items.size();
+            for(std::size_t i : permutation) {
+                if(_items.size() > first &&
+                   group_pairs[i].first <= _value_cost_pairs.back().first)
+                    continue;
+                _items.emplace_back(group_items[i]);
+                _value_cost_pairs.emplace_back(group_pairs[i]);
+            }
+            if(_items.size() == first) {
+                _feasible = false;
+            } else {
+                min_costs_sum += _value_cost_pairs[first].second;
+            }
+            _groups_offsets.push_back(_items.size());
+        }
+        if(min_costs_sum > _budget) _feasible = false;
+    }
+
+    void solve() {
+        _best_sol.clear();
+        if(!_feasible) return;
+        _best_sol = solve_lp_relaxation();
+        if constexpr(std::integral<V>) {
+            if(static_cast<double>(solution_value(_best_sol) + 1) >
+               _lp_bound + bound_tolerance)
+                return;
+        }
+        solve_dp();
+    }
+
+    bool feasible() const noexcept { return _feasible; }
+    double lp_bound() const noexcept { return _lp_bound; }
+
+    // the chosen item of each group, empty if no choice fits the budget
+    auto solution() const noexcept {
+        return std::views::iota(std::size_t{0}, _best_sol.size()) |
+               std::views::transform([this](std::size_t g) {
+                   return _items[_groups_offsets[g] + _best_sol[g]];
+               });
+    }
+};
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_MULTIPLE_CHOICE_KNAPSACK_DP_HPP
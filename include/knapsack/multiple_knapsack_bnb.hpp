@@ -0,0 +1,243 @@
+#ifndef FHAMONIC_KNAPSACK_MULTIPLE_KNAPSACK_BNB_HPP
+#define FHAMONIC_KNAPSACK_MULTIPLE_KNAPSACK_BNB_HPP
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "knapsack/integer_ratio.hpp"
+#include "knapsack/knapsack_bnb.hpp"
+#include "knapsack/lp_bound.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+// Multiple knapsack problem : assign each item to at most one of several
+// knapsacks of given budgets, maximizing the total value of assigned items.
+// Bound-and-bound in the spirit of MTM : the surrogate relaxation (a single
+// knapsack of the summed budgets left) is solved exactly by knapsack_bnb and
+// gives the upper bounds, knapsack_bnb is also used to fill the knapsacks one
+// after the other (smallest first) and gives the initial lower bound. When
+// they differ, a recursive depth first search over the items, in decreasing
+// value/cost ratio, tries every knapsack for each item. Each node is pruned
+// by the LP bound of the surrogate relaxation of the remaining items, then,
+// if it does not prune, by its exact solution.
+template <typename RB, typename RI, typename VM, typename CM>
+class multiple_knapsack_bnb {
+private:
+    using C = std::ranges::range_value_t<RB>;
+    using I = std::ranges::range_value_t<RI>;
+    using V = std::invoke_result_t<VM, I>;
+
+    static constexpr std::size_t unassigned =
+        std::numeric_limits<std::size_t>::max();
+
+    // maps of the sorted items, given by their indices, for knapsack_bnb
+    struct sorted_value_map {
+        const std::vector<V> * values;
+        V operator()(const std::size_t i) const noexcept {
+            return (*values)[i];
+        }
+    };
+    struct sorted_cost_map {
+        const std::vector<C> * costs;
+        C operator()(const std::size_t i) const noexcept {
+            return (*costs)[i];
+        }
+    };
+    using single_knapsack_bnb =
+        knapsack_bnb<C, std::span<const std::size_t>, sorted_value_map,
+                     sorted_cost_map>;
+
+    // by increasing budget
+    std::vector<C> _budgets;
+    std::vector<std::size_t> _budgets_indices;
+    // items sorted by decreasing value/cost ratio
+    std::vector<I> _permuted_items;
+    std::vector<V> _values;
+    std::vector<C> _costs;
+    // 0 to the number of items, whose suffixes are the remaining items
+    std::vector<std::size_t> _indices;
+    single_knapsack_bnb _single_knapsack;
+
+    V _upper_bound;
+    V _best_sol_value;
+    std::vector<std::size_t> _best_sol;
+    std::vector<std::size_t> _current_sol;
+    std::vector<C> _budgets_left;
+
+private:
+    static double value_cost_ratio(const V value, const C cost) noexcept {
+        if constexpr(std::numeric_limits<float>::is_iec559) {
+            return value / static_cast<double>(cost);
+        } else {
+            return (cost == 0) ? std::numeric_limits<double>::max()
+                               : (value / static_cast<double>(cost));
+        }
+    }
+
+    V computeUpperBound(const std::size_t i, const V bound_value,
+                        const C bound_budget_left) const noexcept {
+        return detail::lp_bound(_values.data(), _costs.data(), i,
+                                _values.size(), bound_value,
+                                bound_budget_left);
+    }
+
+    // optimal value of the single knapsack of the given items and budget
+    V solve_single_knapsack(const C budget,
+                            std::span<const std::size_t> items) noexcept {
+        _single_knapsack.reset(budget, items, sorted_value_map{&_values},
+                               sorted_cost_map{&_costs});
+        _single_knapsack.solve();
+        return _single_knapsack.solution_value();
+    }
+
+    void greedy_lower_bound() noexcept {
+        std::vector<std::size_t> remaining_items = _indices;
+        _best_sol.assign(_values.size(), unassigned);
+        _best_sol_value = 0;
+        for(std::size_t k = 0; k < _budgets.size(); ++k) {
+            solve_single_knapsack(_budgets[k], remaining_items);
+            for(auto && i : _single_knapsack.solution()) {
+                _best_sol[i] = k;
+                _best_sol_value += _values[i];
+            }
+            std::erase_if(remaining_items, [this](std::size_t i) {
+                return _best_sol[i] != unassigned;
+            });
+        }
+    }
+
+    void recursive_bnb(std::size_t i, V current_sol_value,
+                       C total_budget_left) noexcept {
+        if(current_sol_value > _best_sol_value) {
+            _best_sol_value = current_sol_value;
+            _best_sol = _current_sol;
+        }
+        for(; i < _values.size(); ++i) {
+            if(_best_sol_value >= _upper_bound) return;
+            const V value = _values[i];
+            const C cost = _costs[i];
+            if(total_budget_left < cost) continue;
+            if(computeUpperBound(i, current_sol_value, total_budget_left) <=
+               _best_sol_value)
+                return;
+            if(current_sol_value +
+                   solve_single_knapsack(
+                       total_budget_left,
+                       std::span<const std::size_t>(_indices).subspan(i)) <=
+               _best_sol_value)
+                return;
+            for(std::size_t k = 0; k < _budgets_left.size(); ++k) {
+                if(_budgets_left[k] < cost) continue;
+                // knapsacks with equal budget left lead to symmetric subtrees
+                if(std::find(_budgets_left.begin(),
+                             _budgets_left.begin() +
+                                 static_cast<std::ptrdiff_t>(k),
+                             _budgets_left[k]) !=
+                   _budgets_left.begin() + static_cast<std::ptrdiff_t>(k))
+                    continue;
+                _budgets_left[k] -= cost;
+                _current_sol[i] = k;
+                recursive_bnb(i + 1, current_sol_value + value,
+                              total_budget_left - cost);
+                _current_sol[i] = unassigned;
+                _budgets_left[k] += cost;
+            }
+        }
+    }
+
+public:
+    multiple_knapsack_bnb(const RB & budgets, const RI & items,
+                          const VM & value_map, const CM & cost_map) noexcept
+        : _upper_bound(0)
+        , _best_sol_value(0) {
+        const std::vector<C> budgets_vector(std::ranges::begin(budgets),
+                                            std::ranges::end(budgets));
+        _budgets_indices.resize(budgets_vector.size());
+        std::iota(_budgets_indices.begin(), _budgets_indices.end(),
+                  std::size_t{0});
+        std::ranges::stable_sort(_budgets_indices, {}, [&](std::size_t k) {
+            return budgets_vector[k];
+        });
+        _budgets.reserve(budgets_vector.size());
+        for(const std::size_t k : _budgets_indices)
+            _budgets.push_back(budgets_vector[k]);
+        const C max_budget = _budgets.empty() ? C{0} : _budgets.back();
+
+        std::vector<I> filtered_items;
+        std::vector<V> values;
+        std::vector<C> costs;
+        for(auto && i : items) {
+            const V value = value_map(i);
+            if(value == static_cast<V>(0)) continue;
+            const C cost = cost_map(i);
+            if(cost > max_budget) continue;
+            filtered_items.emplace_back(i);
+            values.push_back(value);
+            costs.push_back(cost);
+        }
+
+        const std::size_t nb_items = values.size();
+        std::vector<std::size_t> permutation(nb_items);
+        std::iota(permutation.begin(), permutation.end(), std::size_t{0});
+        if constexpr(detail::exact_ratios<V, C>) {
+            std::ranges::sort(permutation, [&](std::size_t i, std::size_t j) {
+                return detail::higher_ratio(values[i], costs[i], values[j],
+                                            costs[j]);
+            });
+        } else {
+            std::vector<double> ratios(nb_items);
+            for(std::size_t i = 0; i < nb_items; ++i)
+                ratios[i] = value_cost_ratio(values[i], costs[i]);
+            std::ranges::sort(permutation, [&](std::size_t i, std::size_t j) {
+                return ratios[i] > ratios[j];
+            });
+        }
+        _permuted_items.reserve(nb_items);
+        _values.reserve(nb_items);
+        _costs.reserve(nb_items);
+        for(const std::size_t i : permutation) {
+            _permuted_items.emplace_back(std::move(filtered_items[i]));
+            _values.push_back(values[i]);
+            _costs.push_back(costs[i]);
+        }
+        _indices.resize(nb_items);
+        std::iota(_indices.begin(), _indices.end(), std::size_t{0});
+    }
+
+    void solve() noexcept {
+        const C total_budget =
+            std::accumulate(_budgets.begin(), _budgets.end(), C{0});
+        _upper_bound = solve_single_knapsack(total_budget, _indices);
+        greedy_lower_bound();
+        if(_best_sol_value >= _upper_bound) return;
+        _current_sol.assign(_values.size(), unassigned);
+        _budgets_left = _budgets;
+        recursive_bnb(0, 0, total_budget);
+    }
+
+    V upper_bound() const noexcept { return _upper_bound; }
+
+    // pairs (item, index of its knapsack in the budgets range)
+    auto solution() const noexcept {
+        return std::views::iota(std::size_t{0}, _best_sol.size()) |
+               std::views::filter([this](std::size_t i) {
+                   return _best_sol[i] != unassigned;
+               }) |
+               std::views::transform([this](std::size_t i) {
+                   return std::make_pair(_permuted_items[i],
+                                         _budgets_indices[_best_sol[i]]);
+               });
+    }
+};
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_MULTIPLE_KNAPSACK_BNB_HPP
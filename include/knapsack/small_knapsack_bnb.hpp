@@ -0,0 +1,280 @@
+#ifndef FHAMONIC_KNAPSACK_SMALL_KNAPSACK_BNB_HPP
+#define FHAMONIC_KNAPSACK_SMALL_KNAPSACK_BNB_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <bitset>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <type_traits>
+
+#include "knapsack/integer_ratio.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+// 0-1 knapsack solver for instances of at most N items, known at compile
+// time, whose whole state lives in fixed size arrays so that neither the
+// construction nor solve() allocate. N is at most 256 for the object and the
+// scratch arrays of the constructor to remain small enough for the stack of
+// any thread :
+//  - the search stack stores 8-bit indices ;
+//  - the solutions are bitsets, so that improving the incumbent copies
+//    N / 64 words ;
+//  - the upper bound finds the critical item by a binary search of fixed
+//    trip count in the prefix sums of the sorted costs ;
+//  - integral budgets up to dp_max_budget are solved by a dynamic program
+//    whose inner loop has no branch.
+// Items are identified by their position in the item range, whose size must
+// not exceed N, which is asserted, the items after the N-th being ignored
+// otherwise.
+//   small_knapsack_bnb<64, int, int> knapsack(budget, items, value_map,
+//                                             cost_map);
+template <std::size_t N, typename V, typename C>
+    requires(N > 0 && N <= 256)
+class small_knapsack_bnb {
+public:
+    using index = std::uint8_t;
+
+    // largest budget solved by the dynamic program, that records the taken
+    // items in one word of bits per item
+    static constexpr std::size_t dp_max_budget = 63;
+
+private:
+    // size of the bound arrays, padded to a power of two for the binary
+    // search of the critical item
+    static constexpr std::size_t nb_slots = std::bit_ceil(N + 1);
+    // sums of costs, that may exceed the budget, wide enough for integral
+    // costs not to overflow
+    using cost_sum =
+        std::conditional_t<std::is_void_v<detail::product_t<C, C>>, C,
+                           detail::product_t<C, C>>;
+
+    C _budget;
+    std::size_t _nb_items;
+    // items of value > 0 and cost <= budget sorted by decreasing value/cost
+    // ratio, followed by padding items of value 0 and cost 1
+    std::array<V, nb_slots> _values;
+    std::array<C, nb_slots> _costs;
+    // sums of the values and costs of the items before each index, the
+    // padding slots holding the total value and a cost sum above every
+    // searched one
+    std::array<V, nb_slots> _prefix_values;
+    std::array<cost_sum, nb_slots> _prefix_costs;
+    // position of each sorted item in the item range
+    std::array<index, N> _positions;
+    V _best_sol_value;
+    std::bitset<N> _best_sol;  // by positions
+
+private:
+    static double value_cost_ratio(const V value, const C cost) noexcept {
+        if constexpr(std::numeric_limits<float>::is_iec559) {
+            return value / static_cast<double>(cost);
+        } else {
+            return (cost == 0) ? std::numeric_limits<double>::max()
+                               : (value / static_cast<double>(cost));
+        }
+    }
+
+    V computeUpperBound(const std::size_t i, const V bound_value,
+                        const C bound_budget_left) const noexcept {
+        const cost_sum target =
+            _prefix_costs[i] + static_cast<cost_sum>(bound_budget_left);
+        // last k such that the items from i to k - 1 fit, k >= i
+        std::size_t k = 0;
+        for(std::size_t step = nb_slots / 2; step > 0; step /= 2)
+            k = (_prefix_costs[k + step] <= target) ? k + step : k;
+        // lower than the cost of item k, or than the budget if k = n
+        const C budget_left = static_cast<C>(target - _prefix_costs[k]);
+        // the padding item of value 0 makes the fractional part 0 if k = n
+        if constexpr(detail::exact_ratios<V, C>)
+            return bound_value + (_prefix_values[k] - _prefix_values[i]) +
+                   detail::fractional_value(budget_left, _values[k],
+                                            _costs[k]);
+        else
+            return static_cast<V>(
+                bound_value + (_prefix_values[k] - _prefix_values[i]) +
+                budget_left * _values[k] / static_cast<double>(_costs[k]));
+    }
+
+    // sorted indices of the solution to their positions
+    void set_solution(const std::bitset<N> & sorted_sol) noexcept {
+        _best_sol.reset();
+        for(std::size_t i = 0; i < _nb_items; ++i)
+            if(sorted_sol[i]) _best_sol.set(_positions[i]);
+    }
+
+    void iterative_bnb() noexcept {
+        _best_sol_value = 0;
+        _best_sol.reset();
+        if(_nb_items == 0) return;
+        std::array<index, N> trail;
+        std::size_t depth = 0;
+        std::bitset<N> current_sol;
+        std::bitset<N> best_sol;
+        std::size_t i = 0;
+        V current_sol_value = 0;
+        V best_sol_value = 0;
+        C budget_left = _budget;
+        goto begin;
+    backtrack:
+        while(depth > 0) {
+            i = trail[--depth];
+            current_sol_value -= _values[i];
+            budget_left += _costs[i];
+            current_sol.reset(i);
+            for(++i; i < _nb_items; ++i) {
+                if(budget_left < _costs[i]) continue;
+                if(computeUpperBound(i, current_sol_value, budget_left) <=
+                   best_sol_value)
+                    goto backtrack;
+            begin:
+                current_sol_value += _values[i];
+                budget_left -= _costs[i];
+                current_sol.set(i);
+                trail[depth++] = static_cast<index>(i);
+            }
+            if(current_sol_value <= best_sol_value) continue;
+            best_sol_value = current_sol_value;
+            best_sol = current_sol;
+        }
+        _best_sol_value = best_sol_value;
+        set_solution(best_sol);
+    }
+
+    // Dynamic program on the capacities up to the budget, the taken items
+    // being recorded in one bit per item and capacity. The update of each
+    // capacity is a max and a shifted or, without branches.
+    void dynamic_program() noexcept
+        requires std::integral<C>
+    {
+        constexpr std::size_t nb_words = (dp_max_budget + 1) / 64;
+        const std::size_t budget = static_cast<std::size_t>(_budget);
+        std::array<V, dp_max_budget + 1> best_values;
+        std::fill(best_values.begin(), best_values.begin() + budget + 1, V{0});
+        std::array<std::array<std::uint64_t, nb_words>, N> taken;
+        for(std::size_t i = 0; i < _nb_items; ++i) {
+            const std::size_t cost = static_cast<std::size_t>(_costs[i]);
+            const V value = _values[i];
+            taken[i].fill(0);
+            // by decreasing capacities, a word of bits at a time
+            for(std::size_t word = budget / 64 + 1; word-- > cost / 64;) {
+                const std::size_t first = std::max(word * 64, cost);
+                std::uint64_t bits = 0;
+                for(std::size_t w = std::min(word * 64 + 63, budget) + 1;
+                    w-- > first;) {
+                    const V with = best_values[w - cost] + value;
+                    const bool take = with > best_values[w];
+                    best_values[w] = take ? with : best_values[w];
+                    bits |= std::uint64_t{take} << (w % 64);
+                }
+                taken[i][word] = bits;
+            }
+        }
+        std::bitset<N> best_sol;
+        std::size_t w = budget;
+        for(std::size_t i = _nb_items; i-- > 0;) {
+            if(!((taken[i][w / 64] >> (w % 64)) & 1)) continue;
+            best_sol.set(i);
+            w -= static_cast<std::size_t>(_costs[i]);
+        }
+        _best_sol_value = best_values[budget];
+        set_solution(best_sol);
+    }
+
+public:
+    template <std::ranges::input_range RI, typename VM, typename CM>
+    small_knapsack_bnb(const C budget, const RI & items, const VM & value_map,
+                       const CM & cost_map) noexcept
+        : _budget(budget), _nb_items(0), _best_sol_value(0) {
+        std::array<double, N> ratios;
+        std::array<V, N> values;
+        std::array<C, N> costs;
+        std::array<index, N> positions;
+        std::size_t position = 0;
+        for(auto && i : items) {
+            assert(position < N);
+            if(position == N) break;
+            const V value = value_map(i);
+            const C cost = cost_map(i);
+            if(value != static_cast<V>(0) && cost <= _budget) {
+                if constexpr(!detail::exact_ratios<V, C>)
+                    ratios[_nb_items] = value_cost_ratio(value, cost);
+                values[_nb_items] = value;
+                costs[_nb_items] = cost;
+                positions[_nb_items] = static_cast<index>(position);
+                ++_nb_items;
+            }
+            ++position;
+        }
+        std::array<index, N> permutation;
+        for(std::size_t i = 0; i < _nb_items; ++i)
+            permutation[i] = static_cast<index>(i);
+        auto higher_ratio = [&](const index i, const index j) {
+            if constexpr(detail::exact_ratios<V, C>)
+                return detail::higher_ratio(values[i], costs[i], values[j],
+                                            costs[j]);
+            else
+                return ratios[i] > ratios[j];
+        };
+        if constexpr(N <= 16) {  // what std::sort does on such sizes
+            for(std::size_t k = 1; k < N && k < _nb_items; ++k) {
+                const index i = permutation[k];
+                std::size_t l = k;
+                for(; l > 0 && higher_ratio(i, permutation[l - 1]); --l)
+                    permutation[l] = permutation[l - 1];
+                permutation[l] = i;
+            }
+        } else {
+            std::sort(
+                permutation.begin(),
+                permutation.begin() + static_cast<std::ptrdiff_t>(_nb_items),
+                higher_ratio);
+        }
+        V value_sum = 0;
+        cost_sum costs_sum = 0;
+        for(std::size_t k = 0; k < _nb_items; ++k) {
+            const index i = permutation[k];
+            _values[k] = values[i];
+            _costs[k] = costs[i];
+            _positions[k] = positions[i];
+            _prefix_values[k] = value_sum;
+            _prefix_costs[k] = costs_sum;
+            value_sum += values[i];
+            costs_sum += static_cast<cost_sum>(costs[i]);
+        }
+        // the searched sums are at most the total cost plus the budget
+        for(std::size_t k = _nb_items; k < nb_slots; ++k) {
+            _values[k] = 0;
+            _costs[k] = 1;
+            _prefix_values[k] = value_sum;
+            _prefix_costs[k] = costs_sum + static_cast<cost_sum>(_budget) + 1;
+        }
+        _prefix_costs[_nb_items] = costs_sum;
+    }
+
+    void solve() noexcept {
+        if constexpr(std::integral<C>) {
+            if(static_cast<std::make_unsigned_t<C>>(_budget) <= dp_max_budget) {
+                dynamic_program();
+                return;
+            }
+        }
+        iterative_bnb();
+    }
+
+    V solution_value() const noexcept { return _best_sol_value; }
+
+    // positions of the items of the solution in the item range
+    const std::bitset<N> & solution() const noexcept { return _best_sol; }
+};
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_SMALL_KNAPSACK_BNB_HPP
@@ -0,0 +1,203 @@
+#ifndef FHAMONIC_KNAPSACK_STREAMING_KNAPSACK_BNB_HPP
+#define FHAMONIC_KNAPSACK_STREAMING_KNAPSACK_BNB_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "knapsack/knapsack_bnb.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+// 0-1 knapsack over a multi-pass item range too large to be materialized.
+// The items are read in three passes :
+//  1. a histogram of the value/cost ratios (16 buckets per power of two)
+//     locates the bucket of the critical item ;
+//  2. the items of that bucket are stored and sorted, which gives the
+//     Dantzig ratio lambda, the Lagrangian upper bound
+//     U = lambda * B + sum_i max(0, v_i - lambda * c_i) and the value L of the
+//     greedy solution ;
+//  3. each item i is tested with the bound obtained by fixing it :
+//     U - |d_i| where d_i = v_i - lambda * c_i. If fixing it to 1 cannot beat
+//     L, it is discarded, if fixing it to 0 cannot, it is taken for sure. Only
+//     the other items, the core, are stored and solved by knapsack_bnb.
+// The memory used is thus proportional to the sizes of the critical bucket
+// and of the core instead of the number of items.
+template <typename C, typename RI, typename VM, typename CM>
+    requires std::ranges::forward_range<RI>
+class streaming_knapsack_bnb {
+private:
+    using I = std::ranges::range_value_t<RI>;
+    using V = std::invoke_result_t<VM, I>;
+    using core_solver = knapsack_bnb<C, std::vector<I>, VM, CM>;
+
+    static constexpr int buckets_per_octave = 16;
+    static constexpr int min_exponent =
+        std::numeric_limits<double>::min_exponent -
+        std::numeric_limits<double>::digits;
+    static constexpr int max_exponent =
+        std::numeric_limits<double>::max_exponent;
+    static constexpr std::size_t nb_buckets =
+        static_cast<std::size_t>((max_exponent - min_exponent + 2) *
+                                 buckets_per_octave);
+
+    C _core_budget;
+    std::vector<I> _fixed_items;
+    std::size_t _core_size;
+    std::optional<core_solver> _core_solver;
+
+private:
+    static std::size_t ratio_bucket(const V value, const C cost) noexcept {
+        if(cost == static_cast<C>(0)) return nb_buckets - 1;
+        int exponent;
+        const double mantissa = std::frexp(
+            static_cast<double>(value) / static_cast<double>(cost), &exponent);
+        const int bucket =
+            (exponent - min_exponent) * buckets_per_octave +
+            static_cast<int>((mantissa - 0.5) * 2 * buckets_per_octave);
+        return static_cast<std::size_t>(
+            std::clamp(bucket, 0, static_cast<int>(nb_buckets) - 2));
+    }
+    static double bucket_lower_ratio(const std::size_t bucket) noexcept {
+        const int b = static_cast<int>(bucket);
+        return std::ldexp(0.5 + (b % buckets_per_octave) /
+                                    (2.0 * buckets_per_octave),
+                          b / buckets_per_octave + min_exponent);
+    }
+
+public:
+    streaming_knapsack_bnb(const C budget, const RI & items,
+                           const VM & value_map, const CM & cost_map) noexcept
+        : _core_budget(budget)
+        , _core_size(0) {
+        auto is_candidate = [&](const V value, const C cost) {
+            return value > static_cast<V>(0) && cost <= budget;
+        };
+
+        // pass 1 : ratio histogram
+        std::vector<double> buckets_costs(nb_buckets, 0.0);
+        for(auto && i : items) {
+            const V value = value_map(i);
+            const C cost = cost_map(i);
+            if(!is_candidate(value, cost)) continue;
+            buckets_costs[ratio_bucket(value, cost)] +=
+                static_cast<double>(cost);
+        }
+        double lambda = 0.0;
+        std::size_t critical_bucket = 0;
+        double above_costs = 0.0;
+        for(std::size_t bucket = nb_buckets; bucket-- > 0;) {
+            if(above_costs + buckets_costs[bucket] >
+               static_cast<double>(budget)) {
+                critical_bucket = bucket;
+                lambda = bucket_lower_ratio(bucket);
+                break;
+            }
+            above_costs += buckets_costs[bucket];
+        }
+        buckets_costs = std::vector<double>();
+
+        // pass 2 : only the items of the critical bucket are stored, sorting
+        // them gives the Dantzig ratio lambda and the greedy solution value
+        V above_values = 0;
+        std::vector<std::pair<V, C>> critical_items;
+        if(lambda > 0.0) {
+            for(auto && i : items) {
+                const V value = value_map(i);
+                const C cost = cost_map(i);
+                if(!is_candidate(value, cost)) continue;
+                const std::size_t bucket = ratio_bucket(value, cost);
+                if(bucket > critical_bucket)
+                    above_values += value;
+                else if(bucket == critical_bucket)
+                    critical_items.emplace_back(value, cost);
+            }
+            std::ranges::sort(critical_items, [](auto && a, auto && b) {
+                return static_cast<double>(a.first) *
+                           static_cast<double>(b.second) >
+                       static_cast<double>(b.first) *
+                           static_cast<double>(a.second);
+            });
+        }
+        double upper_bound = 0.0;
+        V lower_bound = above_values;
+        C budget_left = budget - static_cast<C>(above_costs);
+        bool critical_found = false;
+        for(auto && [value, cost] : critical_items) {
+            if(cost <= budget_left) {
+                lower_bound += value;
+                budget_left -= cost;
+            } else if(!critical_found) {
+                lambda = static_cast<double>(value) / static_cast<double>(cost);
+                critical_found = true;
+            }
+        }
+        if(lambda == 0.0) {  // every candidate item fits
+            for(auto && i : items) {
+                const V value = value_map(i);
+                if(is_candidate(value, cost_map(i))) lower_bound += value;
+            }
+            upper_bound = static_cast<double>(lower_bound);
+        } else {
+            upper_bound = lambda * static_cast<double>(budget) +
+                          static_cast<double>(above_values) -
+                          lambda * above_costs;
+            for(auto && [value, cost] : critical_items)
+                upper_bound += std::max(0.0, static_cast<double>(value) -
+                                                 lambda *
+                                                     static_cast<double>(cost));
+        }
+        critical_items = std::vector<std::pair<V, C>>();
+
+        // pass 3 : reduction, only the core is materialized
+        const double tolerance = 1e-9 * std::abs(upper_bound) + 1e-6;
+        const double lb = static_cast<double>(lower_bound);
+        std::vector<I> core_items;
+        for(auto && i : items) {
+            const V value = value_map(i);
+            const C cost = cost_map(i);
+            if(!is_candidate(value, cost)) continue;
+            const double reduced_value = static_cast<double>(value) -
+                                         lambda * static_cast<double>(cost);
+            if(reduced_value <= 0.0) {
+                if(upper_bound + reduced_value + tolerance < lb) continue;
+            } else if(upper_bound - reduced_value + tolerance < lb) {
+                _fixed_items.emplace_back(i);
+                _core_budget -= cost;
+                continue;
+            }
+            core_items.emplace_back(i);
+        }
+        if(_core_budget < static_cast<C>(0)) _core_budget = 0;
+        _core_size = core_items.size();
+        _core_solver.emplace(_core_budget, core_items, value_map, cost_map);
+    }
+
+    void solve() noexcept { _core_solver->solve(); }
+
+    template <typename _Rep, typename _Period>
+    bool solve(const std::chrono::duration<_Rep, _Period> & timeout) noexcept {
+        return _core_solver->solve(timeout);
+    }
+
+    std::size_t core_size() const noexcept { return _core_size; }
+    std::size_t nb_fixed_items() const noexcept { return _fixed_items.size(); }
+
+    auto solution() const noexcept {
+        std::vector<I> solution = _fixed_items;
+        for(auto && i : _core_solver->solution()) solution.emplace_back(i);
+        return solution;
+    }
+};
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_STREAMING_KNAPSACK_BNB_HPP
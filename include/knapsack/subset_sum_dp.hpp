@@ -0,0 +1,183 @@
+#ifndef FHAMONIC_KNAPSACK_SUBSET_SUM_DP_HPP
+#define FHAMONIC_KNAPSACK_SUBSET_SUM_DP_HPP
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "knapsack/allocator_vector.hpp"
+
+namespace fhamonic {
+namespace knapsack {
+
+namespace detail {
+
+// Word-parallel subset-sum kernel : bit w of _reachable tells if a subset of
+// the items costs exactly w. Adding an item of cost c is a shift-or of the
+// whole bitset, i.e. 64 capacities per word operation (and as many words per
+// instruction as the compiler vectorizes). For reconstruction, _reached_by[w]
+// stores the index of the item that first made w reachable, so that w minus
+// its cost was reachable with strictly preceding items.
+template <typename C, typename A = std::allocator<std::byte>>
+    requires std::integral<C>
+class subset_sum_bitset {
+private:
+    using word_t = std::uint64_t;
+    static constexpr std::size_t word_bits = 64;
+    template <typename T>
+    using vector = allocator_vector<T, A>;
+
+    vector<word_t> _reachable;
+    vector<word_t> _next_reachable;
+    vector<std::uint32_t> _reached_by;
+    C _best_cost = 0;
+
+public:
+    constexpr explicit subset_sum_bitset(const A & allocator = A()) noexcept
+        : _reachable(allocator)
+        , _next_reachable(allocator)
+        , _reached_by(allocator) {}
+
+    // with stop_at_budget, the items are no longer processed once the budget
+    // is reached, then smaller capacities may miss some reachable costs
+    template <typename CR>
+    constexpr void solve(const C budget, const CR & costs,
+                         const bool stop_at_budget = true) {
+        const std::size_t nb_bits = static_cast<std::size_t>(budget) + 1;
+        const std::size_t nb_words = (nb_bits + word_bits - 1) / word_bits;
+        const word_t last_word_mask =
+            (nb_bits % word_bits == 0)
+                ? ~word_t{0}
+                : ((word_t{1} << (nb_bits % word_bits)) - 1);
+
+        _reachable.assign(nb_words, 0);
+        _next_reachable.resize(nb_words);
+        _reached_by.resize(nb_bits);
+        _reachable[0] = 1;
+        _best_cost = 0;
+
+        std::uint32_t item_index = 0;
+        for(const C cost : costs) {
+            const std::size_t q = static_cast<std::size_t>(cost) / word_bits;
+            const std::size_t r = static_cast<std::size_t>(cost) % word_bits;
+            const word_t * const cur = _reachable.data();
+            word_t * const next = _next_reachable.data();
+
+            std::copy(cur, cur + q, next);
+            if(r == 0) {
+                for(std::size_t j = q; j < nb_words; ++j)
+                    next[j] = cur[j] | cur[j - q];
+            } else {
+                next[q] = cur[q] | (cur[0] << r);
+                for(std::size_t j = q + 1; j < nb_words; ++j)
+                    next[j] = cur[j] | (cur[j - q] << r) |
+                              (cur[j - q - 1] >> (word_bits - r));
+            }
+            next[nb_words - 1] &= last_word_mask;
+
+            for(std::size_t j = q; j < nb_words; ++j) {
+                for(word_t new_bits = next[j] & ~cur[j]; new_bits;
+                    new_bits &= new_bits - 1) {
+                    _reached_by[j * word_bits + static_cast<std::size_t>(
+                                                    std::countr_zero(
+                                                        new_bits))] =
+                        item_index;
+                }
+            }
+            _reachable.swap(_next_reachable);
+            ++item_index;
+            if(stop_at_budget && reachable(budget)) break;
+        }
+
+        for(std::size_t j = nb_words; j-- > 0;) {
+            if(_reachable[j] == 0) continue;
+            _best_cost = static_cast<C>(
+                j * word_bits + (word_bits - 1) -
+                static_cast<std::size_t>(std::countl_zero(_reachable[j])));
+            break;
+        }
+    }
+
+    constexpr C best_cost() const noexcept { return _best_cost; }
+
+    constexpr bool reachable(const C cost) const noexcept {
+        const std::size_t w = static_cast<std::size_t>(cost);
+        return (_reachable[w / word_bits] >> (w % word_bits)) & 1;
+    }
+
+    template <typename CR, typename F>
+    constexpr void for_each_taken(const CR & costs, F && f) const {
+        for_each_taken(costs, _best_cost, std::forward<F>(f));
+    }
+
+    // cost must be reachable
+    template <typename CR, typename F>
+    constexpr void for_each_taken(const CR & costs, const C cost,
+                                  F && f) const {
+        for(C w = cost; w > 0;) {
+            const std::uint32_t i = _reached_by[static_cast<std::size_t>(w)];
+            f(static_cast<std::size_t>(i));
+            w -= costs[i];
+        }
+    }
+};
+
+}  // namespace detail
+
+template <typename C, typename RI, typename CM,
+          typename A = std::allocator<std::byte>>
+    requires std::integral<C>
+class subset_sum_dp {
+public:
+    using I = std::ranges::range_value_t<RI>;
+
+    C _budget;
+    detail::allocator_vector<I, A> _items;
+    detail::allocator_vector<C, A> _costs;
+    detail::subset_sum_bitset<C, A> _bitset;
+
+public:
+    subset_sum_dp(const C budget, const RI & items, const CM & cost_map,
+                  const A & allocator = A()) noexcept
+        : _budget(budget)
+        , _items(allocator)
+        , _costs(allocator)
+        , _bitset(allocator) {
+        if constexpr(std::ranges::sized_range<RI>) {
+            const std::size_t nb_items = std::ranges::size(items);
+            _items.reserve(nb_items);
+            _costs.reserve(nb_items);
+        }
+
+        for(auto && i : items) {
+            const C cost = cost_map(i);
+            if(cost == static_cast<C>(0)) continue;
+            if(cost > _budget) continue;
+            _items.emplace_back(i);
+            _costs.emplace_back(cost);
+        }
+    }
+
+    void solve() { _bitset.solve(_budget, _costs); }
+
+    C solution_cost() const noexcept { return _bitset.best_cost(); }
+
+    auto solution() const noexcept {
+        std::vector<I> solution;
+        _bitset.for_each_taken(
+            _costs, [&](std::size_t i) { solution.push_back(_items[i]); });
+        return solution;
+    }
+};
+
+}  // namespace knapsack
+}  // namespace fhamonic
+
+#endif  // FHAMONIC_KNAPSACK_SUBSET_SUM_DP_HPP
@@ -1,9 +1,12 @@
 #ifndef UBOUNDED_FHAMONIC_KNAPSACK_BRANCH_AND_BOUND_HPP
 #define UBOUNDED_FHAMONIC_KNAPSACK_BRANCH_AND_BOUND_HPP
 
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <future>
-#include <iterator>
+#include <limits>
 #include <numeric>
 #include <ranges>
 #include <thread>
@@ -11,111 +14,145 @@
 #include <utility>
 #include <vector>
 
-#include <range/v3/algorithm/sort.hpp>
-#include <range/v3/view/transform.hpp>
-#include <range/v3/view/zip.hpp>
+#include "knapsack/allocator_vector.hpp"
 
 namespace fhamonic {
 namespace knapsack {
 
-template <typename C, typename RI, typename VM, typename CM>
+// A is rebound for every internal container, search stack included
+template <typename C, typename RI, typename VM, typename CM,
+          typename A = std::allocator<std::byte>>
 class unbounded_knapsack_bnb {
 private:
     using I = std::ranges::range_value_t<RI>;
     using V = std::invoke_result_t<VM, I>;
+    template <typename T>
+    using vector = detail::allocator_vector<T, A>;
 
     C _budget;
-    std::vector<I> _permuted_items;
-    std::vector<std::pair<V, C>> _value_cost_pairs;
-    std::vector<std::pair<typename std::vector<std::pair<V, C>>::const_iterator,
-                          std::size_t>>
-        _best_sol;
+    // items sorted by decreasing value/cost ratio, stored as separate arrays
+    // so that the bound computations stream contiguous values and costs
+    vector<I> _permuted_items;
+    vector<V> _values;
+    vector<C> _costs;
+    vector<double> _ratios;
+    // pairs of item index and number of copies taken
+    vector<std::pair<std::uint32_t, C>> _best_sol;
 
 private:
-    double value_cost_ratio(const std::pair<V, C> & p) const noexcept {
+    static double value_cost_ratio(const V value, const C cost) noexcept {
         if constexpr(std::numeric_limits<float>::is_iec559) {
-            return p.first / static_cast<double>(p.second);
+            return value / static_cast<double>(cost);
         } else {
-            return (p.second == 0) ? std::numeric_limits<double>::max()
-                                   : (p.first / static_cast<double>(p.second));
+            return (cost == 0) ? std::numeric_limits<double>::max()
+                               : (value / static_cast<double>(cost));
         }
     }
 
-    auto iterative_bnb() noexcept {
+    void iterative_bnb() noexcept {
         _best_sol.resize(0);
-        auto it = _value_cost_pairs.cbegin();
-        const auto end = _value_cost_pairs.cend();
-        std::vector<std::pair<decltype(it), std::size_t>> current_sol;
+        const std::uint32_t nb_items =
+            static_cast<std::uint32_t>(_values.size());
+        if(nb_items == 0) return;
+        std::uint32_t i = 0;
+        vector<std::pair<std::uint32_t, C>> current_sol(get_allocator());
         V current_sol_value = 0;
         V best_sol_value = 0;
         C budget_left = _budget;
+        // _best_sol and current_sol share their first divergence entries
+        std::size_t divergence = 0;
         goto begin;
     backtrack:
         while(!current_sol.empty()) {
-            it = current_sol.back().first;
+            i = current_sol.back().first;
+            divergence = std::min(divergence, current_sol.size() - 1);
             if(--current_sol.back().second == 0) current_sol.pop_back();
-            current_sol_value -= it->first;
-            budget_left += it->second;
-            for(++it; it < end; ++it) {
-                if(budget_left < it->second) continue;
-                if(current_sol_value + budget_left * value_cost_ratio(*it) <=
+            current_sol_value -= _values[i];
+            budget_left += _costs[i];
+            for(++i; i < nb_items; ++i) {
+                if(budget_left < _costs[i]) continue;
+                if(current_sol_value + budget_left * _ratios[i] <=
                    best_sol_value)
                     goto backtrack;
             begin:
-                const std::size_t nb_take =
-                    static_cast<std::size_t>(budget_left / it->second);
-                current_sol_value += static_cast<V>(nb_take) * it->first;
-                budget_left -= static_cast<C>(nb_take) * it->second;
-                current_sol.emplace_back(it, nb_take);
+                const C nb_take = static_cast<C>(
+                    static_cast<std::size_t>(budget_left / _costs[i]));
+                current_sol_value += static_cast<V>(nb_take) * _values[i];
+                budget_left -= nb_take * _costs[i];
+                current_sol.emplace_back(i, nb_take);
             }
             if(current_sol_value <= best_sol_value) continue;
             best_sol_value = current_sol_value;
-            _best_sol = current_sol;
+            _best_sol.resize(divergence);
+            _best_sol.insert(
+                _best_sol.end(),
+                current_sol.begin() + static_cast<std::ptrdiff_t>(divergence),
+                current_sol.end());
+            divergence = current_sol.size();
         }
-        return _best_sol;
     }
 
-    auto iterative_bnb_timeout(std::stop_token stoken) noexcept {
+    void iterative_bnb_timeout(std::stop_token stoken) noexcept {
         _best_sol.resize(0);
-        auto it = _value_cost_pairs.cbegin();
-        const auto end = _value_cost_pairs.cend();
-        std::vector<std::pair<decltype(it), std::size_t>> current_sol;
+        const std::uint32_t nb_items =
+            static_cast<std::uint32_t>(_values.size());
+        if(nb_items == 0) return;
+        std::uint32_t i = 0;
+        vector<std::pair<std::uint32_t, C>> current_sol(get_allocator());
         V current_sol_value = 0;
         V best_sol_value = 0;
         C budget_left = _budget;
+        // _best_sol and current_sol share their first divergence entries
+        std::size_t divergence = 0;
         goto begin;
     backtrack:
         while(!current_sol.empty() && !stoken.stop_requested()) {
-            it = current_sol.back().first;
+            i = current_sol.back().first;
+            divergence = std::min(divergence, current_sol.size() - 1);
             if(--current_sol.back().second == 0) current_sol.pop_back();
-            current_sol_value -= it->first;
-            budget_left += it->second;
-            for(++it; it < end; ++it) {
-                if(budget_left < it->second) continue;
-                if(current_sol_value + budget_left * value_cost_ratio(*it) <=
+            current_sol_value -= _values[i];
+            budget_left += _costs[i];
+            for(++i; i < nb_items; ++i) {
+                if(budget_left < _costs[i]) continue;
+                if(current_sol_value + budget_left * _ratios[i] <=
                    best_sol_value)
                     goto backtrack;
             begin:
-                const std::size_t nb_take =
-                    static_cast<std::size_t>(budget_left / it->second);
-                current_sol_value += static_cast<V>(nb_take) * it->first;
-                budget_left -= static_cast<C>(nb_take) * it->second;
-                current_sol.emplace_back(it, nb_take);
+                const C nb_take = static_cast<C>(
+                    static_cast<std::size_t>(budget_left / _costs[i]));
+                current_sol_value += static_cast<V>(nb_take) * _values[i];
+                budget_left -= nb_take * _costs[i];
+                current_sol.emplace_back(i, nb_take);
             }
             if(current_sol_value <= best_sol_value) continue;
             best_sol_value = current_sol_value;
-            _best_sol = current_sol;
+            _best_sol.resize(divergence);
+            _best_sol.insert(
+                _best_sol.end(),
+                current_sol.begin() + static_cast<std::ptrdiff_t>(divergence),
+                current_sol.end());
+            divergence = current_sol.size();
         }
-        return _best_sol;
     }
 
 public:
     unbounded_knapsack_bnb(const C budget, const RI & items,
-                           const VM & value_map, const CM & cost_map) noexcept
-        : _budget(budget) {
+                           const VM & value_map, const CM & cost_map,
+                           const A & allocator = A()) noexcept
+        : _budget(budget)
+        , _permuted_items(allocator)
+        , _values(allocator)
+        , _costs(allocator)
+        , _ratios(allocator)
+        , _best_sol(allocator) {
+        vector<I> filtered_items(allocator);
+        vector<V> values(allocator);
+        vector<C> costs(allocator);
         if constexpr(std::ranges::sized_range<RI>) {
-            _permuted_items.reserve(std::ranges::size(items));
-            _value_cost_pairs.reserve(std::ranges::size(items));
+            const std::size_t nb_items = std::ranges::size(items);
+            filtered_items.reserve(nb_items);
+            values.reserve(nb_items);
+            costs.reserve(nb_items);
         }
 
         for(auto && i : items) {
@@ -123,27 +160,45 @@ public:
             if(value == static_cast<V>(0)) continue;
             const C cost = cost_map(i);
             if(cost > _budget) continue;
-            _permuted_items.emplace_back(i);
-            _value_cost_pairs.emplace_back(value, cost);
+            filtered_items.emplace_back(i);
+            values.emplace_back(value);
+            costs.emplace_back(cost);
         }
 
-        auto zip_view = ranges::view::zip(_value_cost_pairs, _permuted_items);
-        ranges::sort(zip_view, [this](auto p1, auto p2) {
-            return value_cost_ratio(p1.first) > value_cost_ratio(p2.first);
-        });
+        const std::size_t nb_items = values.size();
+        vector<double> ratios(nb_items, allocator);
+        for(std::size_t i = 0; i < nb_items; ++i)
+            ratios[i] = value_cost_ratio(values[i], costs[i]);
+        vector<std::uint32_t> permutation(nb_items, allocator);
+        std::iota(permutation.begin(), permutation.end(), std::uint32_t{0});
+        std::ranges::sort(permutation,
+                          [&ratios](std::uint32_t i, std::uint32_t j) {
+                              return ratios[i] > ratios[j];
+                          });
+        _permuted_items.reserve(nb_items);
+        _values.reserve(nb_items);
+        _costs.reserve(nb_items);
+        _ratios.reserve(nb_items);
+        for(const std::uint32_t i : permutation) {
+            _permuted_items.emplace_back(std::move(filtered_items[i]));
+            _values.emplace_back(values[i]);
+            _costs.emplace_back(costs[i]);
+            _ratios.emplace_back(ratios[i]);
+        }
     }
 
+    A get_allocator() const noexcept { return A(_values.get_allocator()); }
+
     void solve() noexcept { iterative_bnb(); }
-    
+
     template <typename _Rep, typename _Period>
     bool solve(const std::chrono::duration<_Rep, _Period> & timeout) noexcept {
         if(timeout == timeout.zero()) {
             solve();
             return true;
         }
-        std::jthread t([this](std::stop_token stoken) {
-            return iterative_bnb_timeout(stoken);
-        });
+        std::jthread t(
+            [this](std::stop_token stoken) { iterative_bnb_timeout(stoken); });
         // C++23 should allow to call jthread from future and prevent launching
         // the supplementary thread for join
         auto future = std::async(std::launch::async, &std::jthread::join, &t);
@@ -156,10 +211,8 @@ public:
 
     auto solution() const noexcept {
         return std::ranges::views::transform(_best_sol, [this](auto & p) {
-            return std::make_pair(
-                _permuted_items[static_cast<std::size_t>(
-                    std::distance(_value_cost_pairs.cbegin(), p.first))],
-                p.second);
+            return std::make_pair(_permuted_items[p.first],
+                                  static_cast<std::size_t>(p.second));
         });
     }
 };
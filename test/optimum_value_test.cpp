@@ -1,16 +1,36 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <filesystem>
 #include <iostream>
+#include <limits>
+#include <memory_resource>
+#include <ranges>
+#include <utility>
 
-#include "knapsack/branch_and_bound.hpp"
-#include "knapsack/dynamic_programming.hpp"
+#include "knapsack/huge_pages.hpp"
+#include "knapsack/knapsack_bnb.hpp"
+#include "knapsack/knapsack_bnb_batch.hpp"
+#include "knapsack/knapsack_dp.hpp"
+#include "knapsack/knapsack_solver.hpp"
+#include "knapsack/multidimensional_knapsack_bnb.hpp"
+#include "knapsack/multiple_choice_knapsack_dp.hpp"
+#include "knapsack/multiple_knapsack_bnb.hpp"
+#include "knapsack/small_knapsack_bnb.hpp"
+#include "knapsack/streaming_knapsack_bnb.hpp"
+#include "knapsack/subset_sum_dp.hpp"
+#include "knapsack/unbounded_knapsack_bnb.hpp"
+#include "utils/binary_instance.hpp"
 #include "utils/instance_parsers.hpp"
+#include "utils/pisinger_generator.hpp"
 
 namespace Knapsack = fhamonic::knapsack;
-namespace UnboundedKnapsack = fhamonic::unbounded_knapsack;
 
-std::vector<std::pair<Instance<int, int>, double>> instances;
+using Item = Instance<int, int>::Item;
+
+std::vector<std::pair<Instance<int, int>, int>> instances;
 
 class Environment : public ::testing::Environment {
 public:
@@ -34,18 +54,691 @@ int main(int argc, char ** argv) {
     return RUN_ALL_TESTS();
 }
 
+const auto item_value = [](const Item & i) { return i.value; };
+const auto item_cost = [](const Item & i) { return i.cost; };
+
+int solution_value(auto && solution) {
+    int value = 0;
+    for(const Item & i : solution) value += i.value;
+    return value;
+}
+int solution_cost(auto && solution) {
+    int cost = 0;
+    for(const Item & i : solution) cost += i.cost;
+    return cost;
+}
+
 TEST(KnapsackBNB, OptTest) {
-    Knapsack::BranchAndBound<int, int> solver;
     for(const auto & [instance, opt] : instances) {
-        Knapsack::Solution<int, int> solution = solver.solve(instance);
-        EXPECT_EQ(solution.getValue(), opt);
+        auto solver = Knapsack::knapsack_bnb(
+            instance.getBudget(), instance.items(), item_value, item_cost);
+        solver.solve();
+        EXPECT_EQ(solution_value(solver.solution()), opt);
+    }
+}
+
+TEST(KnapsackBNB, SearchStrategyTest) {
+    for(const auto strategy :
+        {Knapsack::search_strategy::depth_first,
+         Knapsack::search_strategy::best_first,
+         Knapsack::search_strategy::hybrid}) {
+        // 64 nodes forces the depth-first fallback
+        for(const std::size_t max_nodes :
+            {std::size_t{64}, std::size_t{1} << 22}) {
+            for(const auto & [instance, opt] : instances) {
+                auto solver = Knapsack::knapsack_bnb(
+                    instance.getBudget(), instance.items(), item_value,
+                    item_cost);
+                solver.solve(strategy, max_nodes);
+                EXPECT_EQ(solution_value(solver.solution()), opt);
+                EXPECT_LE(solution_cost(solver.solution()),
+                          instance.getBudget());
+            }
+        }
+    }
+}
+
+TEST(KnapsackBNB, WarmStartTest) {
+    for(const auto & [instance, opt] : instances) {
+        const auto positions = std::views::iota(std::size_t{0},
+                                                instance.itemCount());
+        auto position_value = [&instance](std::size_t i) {
+            return instance[i].value;
+        };
+        auto position_cost = [&instance](std::size_t i) {
+            return instance[i].cost;
+        };
+        auto solver = Knapsack::knapsack_bnb(
+            instance.getBudget(), positions, position_value, position_cost);
+        solver.solve();
+        const std::vector<std::size_t> optimal_positions(
+            solver.solution().begin(), solver.solution().end());
+        const std::vector<bool> bitset = solver.solution_bitset();
+        EXPECT_EQ(bitset.size(), instance.itemCount());
+        EXPECT_EQ(static_cast<std::size_t>(std::ranges::count(bitset, true)),
+                  optimal_positions.size());
+        for(const std::size_t p : optimal_positions) EXPECT_TRUE(bitset[p]);
+
+        EXPECT_FALSE(solver.warm_start(std::vector{instance.itemCount()}));
+        EXPECT_TRUE(solver.warm_start(optimal_positions));
+        solver.solve();
+        EXPECT_EQ(solver.solution_value(), opt);
+        solver.solve(Knapsack::search_strategy::hybrid);
+        EXPECT_EQ(solver.solution_value(), opt);
+    }
+}
+
+TEST(KnapsackBNB, IncrementalTest) {
+    for(const auto & [instance, opt] : instances) {
+        std::vector<Item> items = instance.items();
+        auto solver = Knapsack::knapsack_bnb(instance.getBudget(), items,
+                                             item_value, item_cost);
+        solver.solve();
+        ASSERT_EQ(solver.solution_value(), opt);
+
+        // each change is undone by the next one
+        const Item doubled(2 * items[0].value, items[0].cost);
+        EXPECT_TRUE(solver.update_item(0, doubled, item_value, item_cost));
+        solver.solve();
+        EXPECT_GE(solver.solution_value(), opt);
+        EXPECT_TRUE(solver.update_item(0, items[0], item_value, item_cost));
+        solver.solve();
+        EXPECT_EQ(solver.solution_value(), opt);
+
+        const std::size_t position =
+            solver.add_item(Item(opt, 1), item_value, item_cost);
+        EXPECT_EQ(position, items.size());
+        solver.solve();
+        EXPECT_GT(solver.solution_value(), opt);
+        EXPECT_TRUE(solver.remove_item(position));
+        solver.solve();
+        EXPECT_EQ(solver.solution_value(), opt);
+
+        // removed and out of range positions are rejected
+        EXPECT_FALSE(solver.remove_item(position));
+        EXPECT_FALSE(solver.update_item(position, items[0], item_value,
+                                        item_cost));
+        EXPECT_FALSE(solver.remove_item(position + 1));
+        solver.solve();
+        EXPECT_EQ(solver.solution_value(), opt);
+
+        solver.set_budget(instance.getBudget() / 2);
+        solver.solve();
+        EXPECT_LE(solution_cost(solver.solution()), instance.getBudget() / 2);
+        solver.set_budget(instance.getBudget());
+        solver.solve();
+        EXPECT_EQ(solver.solution_value(), opt);
+    }
+}
+
+TEST(KnapsackBNB, ExactBoundTest) {
+    // values close to multiples of 2^50 times the costs, whose ratios and
+    // bounds are rounded by doubles
+    using BigItem = std::pair<std::int64_t, int>;
+    std::vector<BigItem> items;
+    for(int k = 0; k < 8; ++k) {
+        const int cost = 16 * (1 + (k * 7) % 10);
+        items.emplace_back((std::int64_t{1} << 50) * cost + (k * 37) % 64,
+                           cost);
+    }
+    auto value = [](const BigItem & i) { return i.first; };
+    auto cost = [](const BigItem & i) { return i.second; };
+    // above small_knapsack_bnb::dp_max_budget
+    for(const int budget : {16 * 13, 16 * 21, 16 * 22}) {
+        auto dp = Knapsack::knapsack_dp(budget, items, value, cost);
+        dp.solve();
+        std::int64_t opt = 0;
+        for(const BigItem & i : dp.solution()) opt += i.first;
+
+        auto solver = Knapsack::knapsack_bnb(budget, items, value, cost);
+        solver.solve();
+        EXPECT_EQ(solver.solution_value(), opt);
+        Knapsack::small_knapsack_bnb<8, std::int64_t, int> small_solver(
+            budget, items, value, cost);
+        small_solver.solve();
+        EXPECT_EQ(small_solver.solution_value(), opt);
+    }
+}
+
+TEST(KnapsackBNB, ResetTest) {
+    auto solver = Knapsack::knapsack_bnb(instances[0].first.getBudget(),
+                                         instances[0].first.items(), item_value,
+                                         item_cost);
+    for(const auto & [instance, opt] : instances) {
+        solver.reset(instance.getBudget(), instance.items(), item_value,
+                     item_cost);
+        solver.solve();
+        EXPECT_EQ(solution_value(solver.solution()), opt);
+        EXPECT_EQ(solver.solution_value(), opt);
+    }
+}
+
+TEST(KnapsackBNBBatch, OptTest) {
+    using ItemSpan = std::span<const Item>;
+    using Batch =
+        Knapsack::knapsack_bnb_batch<int, ItemSpan, decltype(item_value),
+                                     decltype(item_cost)>;
+    std::vector<Batch::instance> batch_instances;
+    std::vector<int> opts;
+    for(int repeat = 0; repeat < 8; ++repeat) {
+        for(const auto & [instance, opt] : instances) {
+            batch_instances.emplace_back(instance.getBudget(),
+                                         ItemSpan(instance.items()));
+            opts.push_back(opt);
+        }
+    }
+    Batch batch(item_value, item_cost, 2);
+    EXPECT_EQ(batch.solve(batch_instances), opts);
+
+    std::vector<int> costs(batch_instances.size());
+    batch.solve(batch_instances,
+                [&costs](std::size_t k, const Batch::solver & solver) {
+                    costs[k] = solution_cost(solver.solution());
+                });
+    for(std::size_t k = 0; k < batch_instances.size(); ++k)
+        EXPECT_LE(costs[k], batch_instances[k].first);
+
+    // the threads are kept across the calls, a small batch being solved by
+    // the calling thread alone
+    for(int repeat = 0; repeat < 4; ++repeat) {
+        EXPECT_EQ(batch.solve(batch_instances), opts);
+        EXPECT_EQ(batch.solve(std::span(batch_instances).first(3)),
+                  std::vector<int>(opts.begin(), opts.begin() + 3));
     }
 }
 
 TEST(KnapsackDP, OptTest) {
-    Knapsack::DynamicProgramming<int, int> solver;
     for(const auto & [instance, opt] : instances) {
-        Knapsack::Solution<int, int> solution = solver.solve(instance);
-        EXPECT_EQ(solution.getValue(), opt);
+        auto solver = Knapsack::knapsack_dp(
+            instance.getBudget(), instance.items(), item_value, item_cost);
+        solver.solve();
+        EXPECT_EQ(solution_value(solver.solution()), opt);
+    }
+}
+
+TEST(KnapsackDP, LazyTableTest) {
+    for(const auto & [instance, opt] : instances) {
+        // the table, of several terabytes, is only allocated by solve()
+        auto huge_dp = Knapsack::knapsack_dp(
+            std::numeric_limits<int>::max() - 1, instance.items(), item_value,
+            item_cost);
+        EXPECT_EQ(huge_dp._items.size(), instance.itemCount());
+
+        auto dp = Knapsack::knapsack_dp(instance.getBudget(), instance.items(),
+                                        item_value, item_cost);
+        dp.solve();
+        dp.solve();
+        EXPECT_EQ(solution_value(dp.solution()), opt);
+    }
+}
+
+TEST(KnapsackDP, ParallelTest) {
+    Knapsack::huge_page_resource resource;
+    for(auto && [instance_class, class_name] : pisinger_class_names) {
+        const Instance<int, int> instance =
+            PisingerInstance<int, int>(instance_class, 40, 1000, 0.5, 7)
+                .toInstance();
+        auto dp = Knapsack::knapsack_dp(instance.getBudget(), instance.items(),
+                                        item_value, item_cost);
+        dp.solve();
+        auto parallel_dp = Knapsack::knapsack_dp(
+            instance.getBudget(), instance.items(), item_value, item_cost,
+            std::pmr::polymorphic_allocator<std::byte>(&resource));
+        parallel_dp.solve_parallel(3);
+        EXPECT_EQ(parallel_dp.value_profile(), dp.value_profile())
+            << class_name;
+        EXPECT_EQ(solution_value(parallel_dp.solution()),
+                  solution_value(dp.solution()))
+            << class_name;
+    }
+}
+
+TEST(KnapsackSolver, OptTest) {
+    for(const auto engine :
+        {Knapsack::knapsack_engine::automatic, Knapsack::knapsack_engine::bnb,
+         Knapsack::knapsack_engine::dp, Knapsack::knapsack_engine::race}) {
+        for(const auto & [instance, opt] : instances) {
+            auto solver = Knapsack::knapsack_solver(
+                instance.getBudget(), instance.items(), item_value, item_cost,
+                {.engine = engine});
+            solver.solve();
+            EXPECT_EQ(solution_value(solver.solution()), opt)
+                << solver.decision();
+            if(engine != Knapsack::knapsack_engine::automatic &&
+               engine != Knapsack::knapsack_engine::race) {
+                EXPECT_EQ(solver.solved_by(), engine);
+            }
+        }
+    }
+}
+
+TEST(KnapsackSolver, MaxDPMemoryTest) {
+    // the requested engines fall back to knapsack_bnb if the table is too big
+    for(const auto engine :
+        {Knapsack::knapsack_engine::dp, Knapsack::knapsack_engine::race}) {
+        for(const auto & [instance, opt] : instances) {
+            auto solver = Knapsack::knapsack_solver(
+                instance.getBudget(), instance.items(), item_value, item_cost,
+                {.engine = engine, .max_dp_memory = 1});
+            EXPECT_EQ(solver.engine(), Knapsack::knapsack_engine::bnb)
+                << solver.decision();
+            solver.solve();
+            EXPECT_EQ(solution_value(solver.solution()), opt);
+        }
+    }
+}
+
+TEST(KnapsackSolver, OversizeItemTest) {
+    // the cost 12 of the oversize item is not a multiple of the gcd 5 of the
+    // other costs
+    const std::vector<Item> items = {Item(6, 0), Item(5, 5), Item(7, 12)};
+    for(const auto engine :
+        {Knapsack::knapsack_engine::automatic, Knapsack::knapsack_engine::bnb,
+         Knapsack::knapsack_engine::dp}) {
+        auto solver = Knapsack::knapsack_solver(11, items, item_value,
+                                                item_cost, {.engine = engine});
+        solver.solve();
+        EXPECT_EQ(solution_value(solver.solution()), 11) << solver.decision();
+        EXPECT_LE(solution_cost(solver.solution()), 11) << solver.decision();
+    }
+}
+
+TEST(SmallKnapsackBNB, OptTest) {
+    for(auto && [instance_class, class_name] : pisinger_class_names) {
+        const Instance<int, int> instance =
+            PisingerInstance<int, int>(instance_class, 30, 1000, 0.5, 7)
+                .toInstance();
+        // the second budget is solved by the dynamic program
+        for(const int budget : {instance.getBudget(), 50}) {
+            auto dp = Knapsack::knapsack_dp(budget, instance.items(),
+                                            item_value, item_cost);
+            dp.solve();
+            Knapsack::small_knapsack_bnb<64, int, int> solver(
+                budget, instance.items(), item_value, item_cost);
+            solver.solve();
+            int value = 0;
+            int cost = 0;
+            for(std::size_t i = 0; i < instance.itemCount(); ++i) {
+                if(!solver.solution()[i]) continue;
+                value += instance[i].value;
+                cost += instance[i].cost;
+            }
+            EXPECT_EQ(value, solution_value(dp.solution())) << class_name;
+            EXPECT_EQ(solver.solution_value(), value) << class_name;
+            EXPECT_LE(cost, budget) << class_name;
+        }
+    }
+}
+
+TEST(SmallKnapsackBNB, LargeCostTest) {
+    // the sums of the costs exceed the range of int
+    std::vector<Item> items;
+    for(int k = 0; k < 20; ++k)
+        items.emplace_back(1 + (k * 73) % 1000,
+                           400000000 + (k * 1299709) % 600 * 1000003);
+    const int budget = 2000000000;
+    auto bnb = Knapsack::knapsack_bnb(budget, items, item_value, item_cost);
+    bnb.solve();
+    Knapsack::small_knapsack_bnb<32, int, int> solver(budget, items,
+                                                      item_value, item_cost);
+    solver.solve();
+    int value = 0;
+    std::int64_t cost = 0;
+    for(std::size_t i = 0; i < items.size(); ++i) {
+        if(!solver.solution()[i]) continue;
+        value += items[i].value;
+        cost += items[i].cost;
+    }
+    EXPECT_EQ(value, solution_value(bnb.solution()));
+    EXPECT_EQ(solver.solution_value(), value);
+    EXPECT_LE(cost, budget);
+}
+
+TEST(StreamingKnapsackBNB, OptTest) {
+    for(const auto & [instance, opt] : instances) {
+        auto solver = Knapsack::streaming_knapsack_bnb(
+            instance.getBudget(), instance.items(), item_value, item_cost);
+        solver.solve();
+        EXPECT_EQ(solution_value(solver.solution()), opt);
+        EXPECT_LE(solution_cost(solver.solution()), instance.getBudget());
+        EXPECT_LE(solver.core_size() + solver.nb_fixed_items(),
+                  instance.itemCount());
+    }
+}
+
+TEST(SubsetSumDP, OptTest) {
+    for(const auto & [instance, opt] : instances) {
+        auto bnb = Knapsack::knapsack_bnb(instance.getBudget(),
+                                          instance.items(), item_cost, item_cost);
+        bnb.solve();
+        const int subset_sum_opt = solution_cost(bnb.solution());
+
+        auto solver = Knapsack::subset_sum_dp(instance.getBudget(),
+                                              instance.items(), item_cost);
+        solver.solve();
+        EXPECT_EQ(solver.solution_cost(), subset_sum_opt);
+        EXPECT_EQ(solution_cost(solver.solution()), subset_sum_opt);
+
+        auto dp = Knapsack::knapsack_dp(instance.getBudget(), instance.items(),
+                                        item_cost, item_cost);
+        dp.solve();
+        EXPECT_EQ(solution_cost(dp.solution()), subset_sum_opt);
+    }
+}
+
+TEST(MultipleKnapsackBNB, SingleKnapsackOptTest) {
+    for(const auto & [instance, opt] : instances) {
+        const std::vector<int> budgets = {instance.getBudget()};
+        auto solver = Knapsack::multiple_knapsack_bnb(
+            budgets, instance.items(), item_value, item_cost);
+        solver.solve();
+        int value = 0;
+        for(auto && [i, k] : solver.solution()) value += i.value;
+        EXPECT_EQ(value, opt);
+    }
+}
+
+TEST(MultipleKnapsackBNB, FeasibilityTest) {
+    for(const auto & [instance, opt] : instances) {
+        const int budget = instance.getBudget();
+        const std::vector<int> budgets = {budget - budget / 3, budget / 3};
+        auto solver = Knapsack::multiple_knapsack_bnb(
+            budgets, instance.items(), item_value, item_cost);
+        solver.solve();
+        int value = 0;
+        std::vector<int> loads(budgets.size(), 0);
+        for(auto && [i, k] : solver.solution()) {
+            value += i.value;
+            loads[k] += i.cost;
+        }
+        for(std::size_t k = 0; k < budgets.size(); ++k)
+            EXPECT_LE(loads[k], budgets[k]);
+        EXPECT_LE(value, opt);
+        EXPECT_LE(value, solver.upper_bound());
+    }
+}
+
+TEST(MultipleKnapsackBNB, OptTest) {
+    for(int seed = 0; seed < 5; ++seed) {
+        std::vector<Item> items;
+        for(int k = 0; k < 10; ++k)
+            items.emplace_back(5 + (k * 13 + seed * 7) % 20,
+                               3 + (k * 11 + seed * 5) % 12);
+        const std::vector<int> budgets = {10 + seed, 17 - seed, 13};
+        // brute force over the assignments of each item to a knapsack or to
+        // none, encoded in base budgets.size() + 1
+        const std::size_t nb_choices = budgets.size() + 1;
+        std::size_t nb_assignments = 1;
+        for(std::size_t k = 0; k < items.size(); ++k)
+            nb_assignments *= nb_choices;
+        int opt = 0;
+        for(std::size_t assignment = 0; assignment < nb_assignments;
+            ++assignment) {
+            int value = 0;
+            std::vector<int> loads(budgets.size(), 0);
+            std::size_t code = assignment;
+            for(const Item & i : items) {
+                const std::size_t choice = code % nb_choices;
+                code /= nb_choices;
+                if(choice == budgets.size()) continue;
+                value += i.value;
+                loads[choice] += i.cost;
+            }
+            bool fits = true;
+            for(std::size_t k = 0; k < budgets.size(); ++k)
+                fits = fits && loads[k] <= budgets[k];
+            if(fits) opt = std::max(opt, value);
+        }
+
+        auto solver = Knapsack::multiple_knapsack_bnb(budgets, items,
+                                                      item_value, item_cost);
+        solver.solve();
+        int value = 0;
+        std::vector<int> loads(budgets.size(), 0);
+        for(auto && [i, k] : solver.solution()) {
+            value += i.value;
+            loads[k] += i.cost;
+        }
+        EXPECT_EQ(value, opt) << seed;
+        for(std::size_t k = 0; k < budgets.size(); ++k)
+            EXPECT_LE(loads[k], budgets[k]) << seed;
+        EXPECT_LE(opt, solver.upper_bound()) << seed;
+    }
+}
+
+TEST(MultidimensionalKnapsackBNB, OptTest) {
+    for(const auto & [instance, opt] : instances) {
+        // the second dimension duplicates the first one with a looser budget
+        const std::vector<int> budgets = {instance.getBudget(),
+                                          2 * instance.getBudget()};
+        const std::vector cost_maps = {item_cost, item_cost};
+        auto solver = Knapsack::multidimensional_knapsack_bnb(
+            budgets, instance.items(), item_value, cost_maps);
+        solver.solve();
+        EXPECT_EQ(solution_value(solver.solution()), opt);
+    }
+}
+
+TEST(MultidimensionalKnapsackBNB, BindingOptTest) {
+    // items of a value and a cost in each of the two dimensions, whose costs
+    // are anti-correlated so that both budgets bind
+    using Item2 = std::array<int, 3>;
+    const auto item2_value = [](const Item2 & i) { return i[0]; };
+    const auto item2_cost = [](const std::size_t d) {
+        return [d](const Item2 & i) { return i[1 + d]; };
+    };
+    const std::vector cost_maps = {item2_cost(0), item2_cost(1)};
+    for(int seed = 0; seed < 5; ++seed) {
+        std::vector<Item2> items;
+        for(int k = 0; k < 16; ++k) {
+            const int cost = 5 + (k * 7 + seed * 11) % 20;
+            items.push_back({10 + (k * 37 + seed * 5) % 50, cost,
+                             30 - cost + (k * (seed + 1)) % 5});
+        }
+        const std::vector<int> budgets = {60 + 4 * seed, 80 - 4 * seed};
+        // brute force optima under both budgets, and under each one alone
+        std::array<int, 3> opts = {0, 0, 0};
+        for(std::size_t subset = 0; subset < (std::size_t{1} << items.size());
+            ++subset) {
+            std::array<int, 3> sums = {0, 0, 0};
+            for(std::size_t k = 0; k < items.size(); ++k) {
+                if(!((subset >> k) & 1)) continue;
+                for(std::size_t j = 0; j < 3; ++j) sums[j] += items[k][j];
+            }
+            const bool fits0 = sums[1] <= budgets[0];
+            const bool fits1 = sums[2] <= budgets[1];
+            if(fits0 && fits1) opts[0] = std::max(opts[0], sums[0]);
+            if(fits0) opts[1] = std::max(opts[1], sums[0]);
+            if(fits1) opts[2] = std::max(opts[2], sums[0]);
+        }
+        ASSERT_LT(opts[0], opts[1]) << seed;
+        ASSERT_LT(opts[0], opts[2]) << seed;
+
+        auto solver = Knapsack::multidimensional_knapsack_bnb(
+            budgets, items, item2_value, cost_maps);
+        solver.solve();
+        std::array<int, 3> sums = {0, 0, 0};
+        for(const Item2 & i : solver.solution())
+            for(std::size_t j = 0; j < 3; ++j) sums[j] += i[j];
+        EXPECT_EQ(sums[0], opts[0]) << seed;
+        EXPECT_LE(sums[1], budgets[0]) << seed;
+        EXPECT_LE(sums[2], budgets[1]) << seed;
+    }
+}
+
+TEST(MultipleChoiceKnapsackDP, OptTest) {
+    const std::vector<std::vector<Item>> groups = {
+        {Item(3, 2), Item(5, 4), Item(4, 5)},
+        {Item(2, 1), Item(6, 5)},
+        {Item(1, 0), Item(4, 3)}};
+    auto solver =
+        Knapsack::multiple_choice_knapsack_dp(8, groups, item_value, item_cost);
+    solver.solve();
+    EXPECT_TRUE(solver.feasible());
+    EXPECT_EQ(std::ranges::distance(solver.solution()), 3);
+    EXPECT_EQ(solution_value(solver.solution()), 11);
+    EXPECT_LE(solution_cost(solver.solution()), 8);
+    EXPECT_GE(solver.lp_bound(), 11.0);
+}
+
+TEST(ValueProfile, DPvsBNBTest) {
+    for(const auto & [instance, opt] : instances) {
+        auto dp = Knapsack::knapsack_dp(instance.getBudget(), instance.items(),
+                                        item_value, item_cost);
+        dp.solve();
+        const std::vector<int> dp_profile = dp.value_profile();
+        ASSERT_EQ(dp_profile.size(),
+                  static_cast<std::size_t>(instance.getBudget() + 1));
+        EXPECT_EQ(dp_profile.back(), opt);
+
+        std::vector<int> budgets;
+        for(int b = instance.getBudget(); b >= 0; b -= 1 + b / 7)
+            budgets.push_back(b);
+        auto bnb = Knapsack::knapsack_bnb(instance.getBudget(),
+                                          instance.items(), item_value,
+                                          item_cost);
+        const std::vector<int> bnb_profile = bnb.value_profile(budgets);
+        for(std::size_t k = 0; k < budgets.size(); ++k) {
+            const int budget = budgets[k];
+            const auto b = static_cast<std::size_t>(budget);
+            EXPECT_EQ(bnb_profile[k], dp_profile[b]);
+            EXPECT_EQ(solution_value(dp.solution(budget)), dp_profile[b]);
+            EXPECT_LE(solution_cost(dp.solution(budget)), budget);
+        }
+        EXPECT_EQ(solution_value(bnb.solution()), opt);
+
+        // the budgets above the constructor one are lowered to it
+        const int above = 2 * instance.getBudget() + 1;
+        EXPECT_EQ(bnb.value_profile(std::vector<int>{above}),
+                  std::vector<int>{opt});
+        EXPECT_EQ(solution_value(dp.solution(above)), opt);
+        EXPECT_LE(solution_cost(dp.solution(above)), instance.getBudget());
+    }
+}
+
+TEST(Allocator, MonotonicResourceTest) {
+    using Alloc = std::pmr::polymorphic_allocator<std::byte>;
+    // any allocation that does not go through the arena would throw
+    std::pmr::memory_resource * const default_resource =
+        std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    for(const auto & [instance, opt] : instances) {
+        std::pmr::monotonic_buffer_resource arena(
+            std::pmr::new_delete_resource());
+        auto bnb =
+            Knapsack::knapsack_bnb(instance.getBudget(), instance.items(),
+                                   item_value, item_cost, Alloc(&arena));
+        bnb.solve();
+        EXPECT_EQ(bnb.solution_value(), opt);
+        auto dp = Knapsack::knapsack_dp(instance.getBudget(), instance.items(),
+                                        item_value, item_cost, Alloc(&arena));
+        dp.solve();
+        EXPECT_EQ(solution_value(dp.solution()), opt);
+        auto ukp = Knapsack::unbounded_knapsack_bnb(
+            instance.getBudget(), instance.items(), item_value, item_cost,
+            Alloc(&arena));
+        ukp.solve();
+        int ukp_cost = 0;
+        for(auto && [i, nb_taken] : ukp.solution())
+            ukp_cost += i.cost * static_cast<int>(nb_taken);
+        EXPECT_LE(ukp_cost, instance.getBudget());
+    }
+    std::pmr::set_default_resource(default_resource);
+}
+
+// (value, cost) pairs solved in constant evaluation
+using ConstexprItem = std::pair<int, int>;
+constexpr std::array<ConstexprItem, 6> constexpr_items = {
+    {{10, 5}, {40, 4}, {30, 6}, {50, 3}, {35, 7}, {12, 2}}};
+constexpr auto constexpr_value = [](const ConstexprItem & i) {
+    return i.first;
+};
+constexpr auto constexpr_cost = [](const ConstexprItem & i) {
+    return i.second;
+};
+
+constexpr int constexpr_bnb_value(const int budget) {
+    auto solver = Knapsack::knapsack_bnb(budget, constexpr_items,
+                                         constexpr_value, constexpr_cost);
+    solver.solve();
+    return solver.solution_value();
+}
+
+constexpr int constexpr_dp_value(const int budget) {
+    auto solver = Knapsack::knapsack_dp(budget, constexpr_items,
+                                        constexpr_value, constexpr_cost);
+    solver.solve();
+    int value = 0;
+    for(const ConstexprItem & i : solver.solution()) value += i.first;
+    return value;
+}
+
+constexpr std::array<int, 28> constexpr_value_profile() {
+    auto solver = Knapsack::knapsack_dp(27, constexpr_items, constexpr_value,
+                                        constexpr_cost);
+    solver.solve();
+    std::array<int, 28> profile{};
+    std::ranges::copy(solver.value_profile(), profile.begin());
+    return profile;
+}
+
+TEST(Constexpr, OptTest) {
+    static_assert(constexpr_bnb_value(10) == 102);
+    static_assert(constexpr_dp_value(10) == 102);
+    constexpr std::array<int, 28> profile = constexpr_value_profile();
+    static_assert(profile[27] == 177);
+    for(int budget = 0; budget < 28; ++budget)
+        EXPECT_EQ(constexpr_bnb_value(budget),
+                  profile[static_cast<std::size_t>(budget)]);
+}
+
+TEST(BinaryInstance, RoundTripTest) {
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "knapsack_round_trip.kbin";
+    for(const auto & [instance, opt] : instances) {
+        write_binary_instance(path, instance);
+        const BinaryInstance<int, int> binary_instance(path);
+        EXPECT_EQ(binary_instance.getBudget(), instance.getBudget());
+        ASSERT_EQ(binary_instance.itemCount(), instance.itemCount());
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(
+                      binary_instance.values().data()) %
+                      BinaryInstanceHeader::alignment,
+                  0u);
+        for(std::size_t i = 0; i < instance.itemCount(); ++i) {
+            EXPECT_EQ(binary_instance.values()[i], instance[i].value);
+            EXPECT_EQ(binary_instance.costs()[i], instance[i].cost);
+        }
+        const auto view = binary_instance.view();
+        auto solver = Knapsack::knapsack_bnb(view.getBudget(), view.items(),
+                                             view.valueMap(), view.costMap());
+        solver.solve();
+        int value = 0;
+        for(const std::size_t i : solver.solution()) value += view.values()[i];
+        EXPECT_EQ(value, opt);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(PisingerGenerator, DPvsBNBTest) {
+    for(auto && [instance_class, class_name] : pisinger_class_names) {
+        const PisingerInstance<int, int> generated(instance_class, 60, 100,
+                                                   0.5, 42);
+        const Instance<int, int> instance = generated.toInstance();
+        ASSERT_EQ(instance.itemCount(), 60u);
+        std::size_t i = 0;
+        for(const Item & item : generated.items()) {
+            EXPECT_EQ(item.value, instance[i].value);
+            EXPECT_EQ(item.cost, instance[i].cost);
+            ++i;
+        }
+
+        auto bnb = Knapsack::knapsack_bnb(generated.getBudget(),
+                                          generated.items(), item_value,
+                                          item_cost);
+        bnb.solve();
+        auto dp = Knapsack::knapsack_dp(instance.getBudget(), instance.items(),
+                                        item_value, item_cost);
+        dp.solve();
+        EXPECT_EQ(solution_value(bnb.solution()), solution_value(dp.solution()))
+            << class_name;
     }
 }